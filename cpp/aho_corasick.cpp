@@ -0,0 +1,315 @@
+// Aho-Corasick automaton stored as a double array: the child of state s by byte c is base[s] + c
+// when check[base[s] + c] == s. Patterns are added first, then Build() freezes the automaton.
+class AhoCorasick
+{
+private:
+    struct TrieNode
+    {
+        vector<pair<unsigned char, int>> Children;
+        int Head;
+
+        TrieNode()
+        {
+            Head = -1;
+        }
+    };
+
+    vector<TrieNode> _trie;
+    vector<int> _patternLength;
+    // patterns that end at the same state are chained through _nextSame
+    vector<int> _nextSame;
+
+    vector<int> _base;
+    vector<int> _check;
+    vector<int> _fail;
+    vector<int> _head;
+    vector<int> _dictLink;
+
+    int _state;
+    ll _position;
+    bool _built;
+
+public:
+    AhoCorasick()
+    {
+        _trie.emplace_back();
+        _state = 0;
+        _position = 0;
+        _built = false;
+    }
+
+    int Add(string_view pattern)
+    {
+        if (_built)
+        {
+            throw exception();
+        }
+
+        int node = 0;
+        for (int i = 0; i < (int)pattern.size(); i++)
+        {
+            unsigned char c = (unsigned char)pattern[i];
+            int next = -1;
+            for (auto& child : _trie[node].Children)
+            {
+                if (child.first == c)
+                {
+                    next = child.second;
+                    break;
+                }
+            }
+
+            if (next == -1)
+            {
+                next = (int)_trie.size();
+                _trie[node].Children.emplace_back(c, next);
+                _trie.emplace_back();
+            }
+            node = next;
+        }
+
+        int id = (int)_patternLength.size();
+        _patternLength.push_back((int)pattern.size());
+        _nextSame.push_back(_trie[node].Head);
+        _trie[node].Head = id;
+
+        return id;
+    }
+
+    int PatternCount()
+    {
+        return (int)_patternLength.size();
+    }
+
+    int PatternLength(int id)
+    {
+        return _patternLength[id];
+    }
+
+    void Build()
+    {
+        if (_built)
+        {
+            return;
+        }
+        _built = true;
+
+        int nodeCount = (int)_trie.size();
+        vector<int> position(nodeCount, -1);
+
+        // free slots of the double array are kept in a linked list so that placing a node skips occupied runs
+        vector<int> nextFree, prevFree;
+        int freeHead = -1;
+        int freeTail = -1;
+        auto grow = [&](int size)
+        {
+            int capacity = (int)_check.size();
+            if (size <= capacity)
+            {
+                return;
+            }
+
+            int next = max(size, 2 * capacity);
+            _check.resize(next, -1);
+            _base.resize(next, 0);
+            nextFree.resize(next);
+            prevFree.resize(next);
+            for (int p = max(capacity, 1); p < next; p++)
+            {
+                prevFree[p] = freeTail;
+                nextFree[p] = -1;
+                if (freeTail == -1)
+                {
+                    freeHead = p;
+                }
+                else
+                {
+                    nextFree[freeTail] = p;
+                }
+                freeTail = p;
+            }
+        };
+        auto take = [&](int p)
+        {
+            if (prevFree[p] == -1) freeHead = nextFree[p];
+            else nextFree[prevFree[p]] = nextFree[p];
+            if (nextFree[p] == -1) freeTail = prevFree[p];
+            else prevFree[nextFree[p]] = prevFree[p];
+        };
+
+        grow(nodeCount + 256);
+        position[0] = 0;
+        _check[0] = 0;
+
+        // place the nodes in BFS order; the BFS order is reused for the failure links
+        vector<int> order;
+        order.reserve(nodeCount);
+        order.push_back(0);
+
+        for (int i = 0; i < (int)order.size(); i++)
+        {
+            TrieNode& node = _trie[order[i]];
+            if (node.Children.empty())
+            {
+                continue;
+            }
+
+            sort(node.Children.begin(), node.Children.end());
+
+            int first = node.Children[0].first;
+            int base = 0;
+            for (int p = freeHead; ; p = nextFree[p])
+            {
+                base = p - first;
+                if (base >= 1)
+                {
+                    grow(base + 256);
+
+                    bool ok = true;
+                    for (auto& child : node.Children)
+                    {
+                        if (_check[base + child.first] != -1)
+                        {
+                            ok = false;
+                            break;
+                        }
+                    }
+
+                    if (ok)
+                    {
+                        break;
+                    }
+                }
+
+                if (nextFree[p] == -1)
+                {
+                    grow(2 * (int)_check.size());
+                }
+            }
+
+            int s = position[order[i]];
+            _base[s] = base;
+            for (auto& child : node.Children)
+            {
+                take(base + child.first);
+                _check[base + child.first] = s;
+                position[child.second] = base + child.first;
+                order.push_back(child.second);
+            }
+        }
+
+        int size = (int)_check.size();
+        _fail.assign(size, 0);
+        _head.assign(size, -1);
+        _dictLink.assign(size, -1);
+
+        for (int v = 0; v < nodeCount; v++)
+        {
+            _head[position[v]] = _trie[v].Head;
+        }
+
+        for (int i = 0; i < (int)order.size(); i++)
+        {
+            int v = order[i];
+            int s = position[v];
+
+            for (auto& child : _trie[v].Children)
+            {
+                int t = position[child.second];
+                int f = 0;
+                if (s != 0)
+                {
+                    f = _fail[s];
+                    while (f != 0 && Go(f, child.first) == -1)
+                    {
+                        f = _fail[f];
+                    }
+
+                    int g = Go(f, child.first);
+                    f = g == -1 ? 0 : g;
+                }
+
+                _fail[t] = f;
+                _dictLink[t] = _head[f] != -1 ? f : _dictLink[f];
+            }
+        }
+
+        _trie.clear();
+        _trie.shrink_to_fit();
+    }
+
+    void Reset()
+    {
+        _state = 0;
+        _position = 0;
+    }
+
+    // feeds the next chunk of a stream; f(id, end) is called for each match of pattern id ending just before
+    // absolute offset end. State carries over between calls, so matches may span chunk boundaries.
+    template <typename F>
+    void Feed(const char* data, ll length, F f)
+    {
+        if (!_built)
+        {
+            Build();
+        }
+
+        int s = _state;
+        int size = (int)_check.size();
+        for (ll i = 0; i < length; i++)
+        {
+            unsigned char c = (unsigned char)data[i];
+            while (true)
+            {
+                int t = _base[s] + c;
+                if (t < size && _check[t] == s && t != 0)
+                {
+                    s = t;
+                    break;
+                }
+
+                if (s == 0)
+                {
+                    break;
+                }
+                s = _fail[s];
+            }
+
+            for (int u = _head[s] != -1 ? s : _dictLink[s]; u != -1; u = _dictLink[u])
+            {
+                for (int id = _head[u]; id != -1; id = _nextSame[id])
+                {
+                    f(id, _position + i + 1);
+                }
+            }
+        }
+
+        _state = s;
+        _position += length;
+    }
+
+    template <typename F>
+    void Feed(string_view chunk, F f)
+    {
+        Feed(chunk.data(), (ll)chunk.size(), f);
+    }
+
+    // counts the occurrences of each pattern in one text
+    void CountAll(string_view text, vector<ll>& counts)
+    {
+        counts.assign(_patternLength.size(), 0);
+        Reset();
+        Feed(text, [&](int id, ll)
+        {
+            counts[id]++;
+        });
+        Reset();
+    }
+
+private:
+    inline int Go(int s, unsigned char c)
+    {
+        int t = _base[s] + c;
+        return t < (int)_check.size() && _check[t] == s && t != 0 ? t : -1;
+    }
+};
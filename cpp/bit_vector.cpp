@@ -0,0 +1,328 @@
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// Succinct bit vector with constant-time rank and sampled select.
+// The rank directory takes one 64-bit entry per 2048-bit superblock (about 3% of the bits): the count before the
+// superblock within its 2^32-bit chunk, and the popcounts of its first three 512-bit subblocks in 10 bits each.
+// Select works on groups of SelectRate ones (or zeros), darray-style: the superblock of each group's first bit is
+// sampled, and a group spanning more than SparseGap superblocks also stores the superblock of every bit it holds.
+// Select is O(1): a table lookup for a sparse group, otherwise a binary search over at most SparseGap superblocks,
+// then at most 3 subblock counts and 8 words. The samples take 1/64 bit per bit; the sparse tables take 32 bits per
+// bit of a group spanning over 2^19 bits, so at most 1/8 bit per bit and far less unless the bits are spread evenly.
+// Positions and select indices are 0-indexed; Select(bit, k) returns the position of the k-th bit, or -1.
+class BitVector
+{
+private:
+    static constexpr size_t SuperBits = 2048;
+    static constexpr size_t SubBits = 512;
+    static constexpr size_t SelectRate = 2048;
+    static constexpr size_t SparseGap = 256;
+
+    size_t _length;
+    size_t _ones;
+    // owned bits; empty when the vector is a view of an external buffer
+    vector<uint64_t> _storage;
+    const uint64_t* _bits;
+    vector<uint64_t> _directory;
+    vector<uint64_t> _chunkRank;
+    // superblocks holding every SelectRate-th one and zero, with the last superblock as a sentinel
+    vector<uint32_t> _selectOne;
+    vector<uint32_t> _selectZero;
+    // the superblocks of the bits in sparse groups; group g owns [_sparseStart[g], _sparseStart[g + 1])
+    vector<uint32_t> _sparseOne;
+    vector<uint32_t> _sparseZero;
+    vector<uint32_t> _sparseStartOne;
+    vector<uint32_t> _sparseStartZero;
+
+public:
+    // all zeros; call Build after setting bits
+    BitVector(size_t length)
+    {
+        _length = length;
+        _storage.assign((length + 63) / 64, 0);
+        _bits = _storage.data();
+        Build();
+    }
+
+    BitVector(vector<uint64_t> words, size_t length)
+    {
+        _length = length;
+        _storage = move(words);
+        _bits = _storage.data();
+        Build();
+    }
+
+    // a view of words that must outlive the vector, such as a MappedFile:
+    // BitVector((const uint64_t*)file.Data(), file.Size() * 8). Only the index is allocated.
+    BitVector(const uint64_t* words, size_t length)
+    {
+        _length = length;
+        _bits = words;
+        Build();
+    }
+
+    BitVector(const BitVector&) = delete;
+    BitVector& operator=(const BitVector&) = delete;
+
+    BitVector(BitVector&& other) noexcept
+    {
+        *this = move(other);
+    }
+
+    BitVector& operator=(BitVector&& other) noexcept
+    {
+        _length = other._length;
+        _ones = other._ones;
+        _storage = move(other._storage);
+        // a view keeps pointing at the external words
+        _bits = _storage.empty() ? other._bits : _storage.data();
+        _directory = move(other._directory);
+        _chunkRank = move(other._chunkRank);
+        _selectOne = move(other._selectOne);
+        _selectZero = move(other._selectZero);
+        _sparseOne = move(other._sparseOne);
+        _sparseZero = move(other._sparseZero);
+        _sparseStartOne = move(other._sparseStartOne);
+        _sparseStartZero = move(other._sparseStartZero);
+        return *this;
+    }
+
+    size_t Length() const
+    {
+        return _length;
+    }
+
+    size_t Ones() const
+    {
+        return _ones;
+    }
+
+    size_t Zeros() const
+    {
+        return _length - _ones;
+    }
+
+    // owned vectors only
+    void Set(size_t i, bool value)
+    {
+        if (_storage.empty())
+        {
+            throw exception();
+        }
+
+        if (value) _storage[i / 64] |= 1ULL << (i % 64);
+        else _storage[i / 64] &= ~(1ULL << (i % 64));
+    }
+
+    // rebuilds the index after Set
+    void Build()
+    {
+        size_t words = (_length + 63) / 64;
+        size_t superCount = _length / SuperBits + 1;
+        _directory.assign(superCount, 0);
+        _chunkRank.assign((_length >> 32) + 1, 0);
+
+        uint64_t rank = 0;
+        for (size_t sb = 0; sb < superCount; sb++)
+        {
+            size_t chunk = (sb * SuperBits) >> 32;
+            if (((sb * SuperBits) & 0xFFFFFFFFULL) == 0)
+            {
+                _chunkRank[chunk] = rank;
+            }
+
+            uint64_t counts[4] = {};
+            for (size_t w = sb * (SuperBits / 64); w < min(words, (sb + 1) * (SuperBits / 64)); w++)
+            {
+                counts[w % (SuperBits / 64) / (SubBits / 64)] += popcount(Word(w));
+            }
+
+            _directory[sb] = ((rank - _chunkRank[chunk]) << 32) | counts[0] | (counts[1] << 10) | (counts[2] << 20);
+            rank += counts[0] + counts[1] + counts[2] + counts[3];
+        }
+        _ones = rank;
+
+        BuildSelect(1, _selectOne, _sparseOne, _sparseStartOne);
+        BuildSelect(0, _selectZero, _sparseZero, _sparseStartZero);
+    }
+
+    inline int Get(size_t i) const
+    {
+        return (int)((_bits[i / 64] >> (i % 64)) & 1);
+    }
+
+    int operator[](size_t i) const
+    {
+        return Get(i);
+    }
+
+    // ones in [0, i)
+    inline size_t Rank1(size_t i) const
+    {
+        size_t sb = i / SuperBits;
+        uint64_t entry = _directory[sb];
+        size_t sub = i % SuperBits / SubBits;
+
+        size_t rank = SuperRank(sb);
+        rank += (sub > 0 ? (entry & 0x3FF) : 0) + (sub > 1 ? ((entry >> 10) & 0x3FF) : 0) + (sub > 2 ? ((entry >> 20) & 0x3FF) : 0);
+
+        size_t w = i / SubBits * (SubBits / 64);
+        for (; w < i / 64; w++)
+        {
+            rank += popcount(_bits[w]);
+        }
+        if (i % 64 != 0)
+        {
+            rank += popcount(_bits[w] & ((1ULL << (i % 64)) - 1));
+        }
+        return rank;
+    }
+
+    inline size_t Rank0(size_t i) const
+    {
+        return i - Rank1(i);
+    }
+
+    size_t Rank(int bit, size_t i) const
+    {
+        return bit == 1 ? Rank1(i) : Rank0(i);
+    }
+
+    ll Select1(size_t k) const
+    {
+        return Select(1, k);
+    }
+
+    ll Select0(size_t k) const
+    {
+        return Select(0, k);
+    }
+
+    ll Select(int bit, size_t k) const
+    {
+        if (k >= (bit == 1 ? _ones : _length - _ones))
+        {
+            return -1;
+        }
+
+        size_t group = k / SelectRate;
+        const vector<uint32_t>& starts = bit == 1 ? _sparseStartOne : _sparseStartZero;
+        size_t sb;
+        if (starts[group] < starts[group + 1])
+        {
+            sb = (bit == 1 ? _sparseOne : _sparseZero)[starts[group] + k % SelectRate];
+        }
+        else
+        {
+            // the last superblock in [lo, hi] that starts with at most k matching bits; hi - lo <= SparseGap
+            const vector<uint32_t>& samples = bit == 1 ? _selectOne : _selectZero;
+            size_t lo = samples[group];
+            size_t hi = samples[group + 1];
+            while (lo < hi)
+            {
+                size_t mid = (lo + hi + 1) / 2;
+                if (MatchingBefore(bit, mid) <= k) lo = mid;
+                else hi = mid - 1;
+            }
+            sb = lo;
+        }
+
+        k -= MatchingBefore(bit, sb);
+
+        uint64_t entry = _directory[sb];
+        size_t sub = 0;
+        for (; sub < 3; sub++)
+        {
+            size_t ones = (entry >> (10 * sub)) & 0x3FF;
+            size_t count = bit == 1 ? ones : SubBits - ones;
+            if (k < count) break;
+            k -= count;
+        }
+
+        for (size_t w = sb * (SuperBits / 64) + sub * (SubBits / 64);; w++)
+        {
+            uint64_t word = bit == 1 ? _bits[w] : ~_bits[w];
+            size_t count = popcount(word);
+            if (k < count)
+            {
+                return (ll)(w * 64 + SelectInWord(word, (int)k));
+            }
+            k -= count;
+        }
+    }
+
+private:
+    inline size_t SuperRank(size_t sb) const
+    {
+        return _chunkRank[(sb * SuperBits) >> 32] + (_directory[sb] >> 32);
+    }
+
+    // ones or zeros before superblock sb
+    inline size_t MatchingBefore(int bit, size_t sb) const
+    {
+        return bit == 1 ? SuperRank(sb) : sb * SuperBits - SuperRank(sb);
+    }
+
+    void BuildSelect(int bit, vector<uint32_t>& samples, vector<uint32_t>& sparse, vector<uint32_t>& starts)
+    {
+        size_t superCount = _directory.size();
+        size_t total = bit == 1 ? _ones : _length - _ones;
+
+        samples.clear();
+        for (size_t sb = 0; sb < superCount; sb++)
+        {
+            size_t before = MatchingBefore(bit, sb);
+            size_t after = sb + 1 < superCount ? MatchingBefore(bit, sb + 1) : total;
+            for (size_t t = (before + SelectRate - 1) / SelectRate * SelectRate; t < after; t += SelectRate)
+            {
+                samples.push_back((uint32_t)sb);
+            }
+        }
+        samples.push_back((uint32_t)(superCount - 1));
+
+        sparse.clear();
+        starts.assign(samples.size(), 0);
+        for (size_t g = 0; g + 1 < samples.size(); g++)
+        {
+            if (samples[g + 1] - samples[g] > SparseGap)
+            {
+                size_t first = g * SelectRate, last = min(total, first + SelectRate);
+                for (size_t sb = samples[g]; sb <= samples[g + 1]; sb++)
+                {
+                    size_t before = MatchingBefore(bit, sb);
+                    size_t after = sb + 1 < superCount ? MatchingBefore(bit, sb + 1) : total;
+                    for (size_t t = max(before, first); t < min(after, last); t++)
+                    {
+                        sparse.push_back((uint32_t)sb);
+                    }
+                }
+            }
+            starts[g + 1] = (uint32_t)sparse.size();
+        }
+    }
+
+    // word w with the bits past _length cleared
+    inline uint64_t Word(size_t w) const
+    {
+        uint64_t word = _bits[w];
+        if ((w + 1) * 64 > _length)
+        {
+            word &= (1ULL << (_length % 64)) - 1;
+        }
+        return word;
+    }
+
+    static inline int SelectInWord(uint64_t word, int k)
+    {
+#if defined(__BMI2__)
+        return __builtin_ctzll(_pdep_u64(1ULL << k, word));
+#else
+        for (int i = 0; i < k; i++)
+        {
+            word &= word - 1;
+        }
+        return __builtin_ctzll(word);
+#endif
+    }
+};
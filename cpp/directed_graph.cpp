@@ -1,3 +1,6 @@
+template <typename T>
+class TopologicalSortWorkspace;
+
 template <typename T>
 class DirectedGraph
 {
@@ -8,6 +11,9 @@ private:
     vector<Edge<T>> _reverseEdges;
     vector<bool> _seen;
     int _vertexCount;
+    ll _version;
+
+    friend class TopologicalSortWorkspace<T>;
 
 public:
     DirectedGraph(int vertexCount)
@@ -17,7 +23,8 @@ public:
         _edges.reserve(_vertexCount);
         _seen.resize(_vertexCount);
         _reverseGraph.resize(_vertexCount);
-        _reverseEdges.reserve(_vertexCount);       
+        _reverseEdges.reserve(_vertexCount);
+        _version = 0;
     }
 
     int VertexCount()
@@ -25,13 +32,21 @@ public:
         return _vertexCount;
     }
 
+    // bumped by AddEdge and by handing out the mutable adjacency, so cached data can tell that it is stale
+    ll Version()
+    {
+        return _version;
+    }
+
     vector<vector<Edge<T>>>& RawGraph()
     {
+        _version++;
         return _graph;
     }
 
     vector<Edge<T>>& Edges()
     {
+        _version++;
         return _edges;
     }
 
@@ -42,6 +57,8 @@ public:
             return;
         }
 
+        _version++;
+
         Edge<T> edge(from, to, weight);
         _graph[from].push_back(edge);
         _edges.push_back(edge);
@@ -170,102 +187,367 @@ public:
 
     bool TryTopologicalSort(vector<int>& sorted)
     {
-        sorted = vector<int>();
-        sorted.reserve(_vertexCount);
+        TopologicalSortWorkspace<T> work(*this);
+        return work.TryTopologicalSort(sorted);
+    }
 
-        vector<int> deg(_vertexCount);
-        for (int i = 0; i < (int)_edges.size(); i++)
-        {
-            deg[_edges[i].To]++;
-        }
+    bool TryUniqueTopologicalSort(vector<int>& sorted)
+    {
+        TopologicalSortWorkspace<T> work(*this);
+        return work.TryUniqueTopologicalSort(sorted);
+    }
 
-        queue<int> q;
-        for (int i = 0; i < _vertexCount; i++)
+    bool TryLexicographicalTopologicalSort(vector<int>& sorted)
+    {
+        TopologicalSortWorkspace<T> work(*this);
+        return work.TryLexicographicalTopologicalSort(sorted);
+    }
+
+    bool TryLayeredTopologicalSort(vector<vector<int>>& layers, int threadCount = 1)
+    {
+        TopologicalSortWorkspace<T> work(*this, threadCount);
+        return work.TryLayeredTopologicalSort(layers);
+    }
+
+    // ids are numbered in topological order of the condensation: every edge goes from a smaller or equal id.
+    int SplitSCC(vector<int>& ids)
+    {
+        ids.assign(_vertexCount, -1);
+
+        vector<int> order;
+        order.reserve(_vertexCount);
+        vector<int> stack(_vertexCount);
+        vector<int> iter(_vertexCount, 0);
+
+        fill(_seen.begin(), _seen.end(), false);
+
+        for (int s = 0; s < _vertexCount; s++)
         {
-            if (deg[i] == 0)
-                q.push(i);
+            if (_seen[s]) continue;
+
+            int top = 0;
+            stack[top++] = s;
+            _seen[s] = true;
+
+            while (top > 0)
+            {
+                int v = stack[top - 1];
+                vector<Edge<T>>& ch = _graph[v];
+
+                if (iter[v] < (int)ch.size())
+                {
+                    int to = ch[iter[v]++].To;
+                    if (!_seen[to])
+                    {
+                        _seen[to] = true;
+                        stack[top++] = to;
+                    }
+                }
+                else
+                {
+                    order.push_back(v);
+                    top--;
+                }
+            }
         }
 
-        while (!q.empty())
+        int count = 0;
+        for (int i = _vertexCount - 1; i >= 0; i--)
         {
-            int next = q.front();
-            q.pop();
+            int s = order[i];
+            if (ids[s] != -1) continue;
 
-            sorted.push_back(next);
+            int top = 0;
+            stack[top++] = s;
+            ids[s] = count;
 
-            vector<Edge<T>>& p = _graph[next];
-            for (int i = 0; i < (int)p.size(); i++)
+            while (top > 0)
             {
-                deg[p[i].To]--;
-                if (deg[p[i].To] < 0)
+                int v = stack[--top];
+                vector<Edge<T>>& ch = _reverseGraph[v];
+                for (int j = 0; j < (int)ch.size(); j++)
                 {
-                    // detected cycle
-                    return false;
+                    if (ids[ch[j].To] == -1)
+                    {
+                        ids[ch[j].To] = count;
+                        stack[top++] = ch[j].To;
+                    }
                 }
+            }
+
+            count++;
+        }
 
-                if (deg[p[i].To] == 0)
+        return count;
+    }
+
+    // builds the condensation DAG in CSR form: the successors of component c are adjacent[start[c]..start[c + 1]).
+    int CondenseSCC(vector<int>& ids, vector<int>& start, vector<int>& adjacent)
+    {
+        int count = SplitSCC(ids);
+
+        start.assign(count + 1, 0);
+        adjacent.clear();
+        adjacent.reserve(_edges.size());
+
+        vector<int> head(count, -1);
+        vector<int> next(_vertexCount, -1);
+        for (int v = _vertexCount - 1; v >= 0; v--)
+        {
+            next[v] = head[ids[v]];
+            head[ids[v]] = v;
+        }
+
+        vector<int> mark(count, -1);
+        for (int c = 0; c < count; c++)
+        {
+            mark[c] = c;
+            for (int v = head[c]; v != -1; v = next[v])
+            {
+                vector<Edge<T>>& ch = _graph[v];
+                for (int j = 0; j < (int)ch.size(); j++)
                 {
-                    q.push(p[i].To);
+                    int to = ids[ch[j].To];
+                    if (mark[to] != c)
+                    {
+                        mark[to] = c;
+                        adjacent.push_back(to);
+                    }
                 }
             }
+            start[c + 1] = (int)adjacent.size();
         }
 
-        return sorted.size() == _vertexCount;
+        return count;
     }
 
-    bool TryUniqueTopologicalSort(vector<int>& sorted)
+private:
+    inline bool Validate(int n)
     {
-        sorted = vector<int>();
-        sorted.reserve(_vertexCount);
+        return 0 <= n && n < _vertexCount;
+    }
+};
 
-        vector<int> deg(_vertexCount);
-        for (int i = 0; i < (int)_edges.size(); i++)
+// Reusable state for the topological sorts of one DirectedGraph: the in-degrees are counted once and kept until the
+// graph's Version() changes or Invalidate() is called, and the queue, layer buffers and worker threads are reused
+// across calls. The graph must outlive the workspace.
+template <typename T>
+class TopologicalSortWorkspace
+{
+private:
+    DirectedGraph<T>& _source;
+    vector<int> _inDegree;
+    ll _version;
+    vector<int> _degree;
+    vector<int> _queue;
+    vector<vector<int>> _found;
+    ThreadPool _pool;
+
+public:
+    // threadCount threads relax the large layers of TryLayeredTopologicalSort
+    TopologicalSortWorkspace(DirectedGraph<T>& graph, int threadCount = 1) : _source(graph), _pool(threadCount)
+    {
+        _version = -1;
+        _found.resize(_pool.ThreadCount());
+    }
+
+    // forces the in-degrees to be recounted, for edits the version cannot see
+    void Invalidate()
+    {
+        _version = -1;
+    }
+
+    bool TryTopologicalSort(vector<int>& sorted)
+    {
+        // the output doubles as the queue: Kahn's algorithm pops vertices in the order they are emitted
+        int n = _source._vertexCount;
+        sorted.resize(n);
+        vector<int>& deg = ResetDegree();
+
+        int head = 0, tail = 0;
+        for (int i = 0; i < n; i++)
         {
-            deg[_edges[i].To]++;
+            if (deg[i] == 0)
+                sorted[tail++] = i;
         }
 
-        queue<int> q;
-        for (int i = 0; i < _vertexCount; i++)
+        while (head < tail)
+        {
+            int next = sorted[head++];
+
+            vector<Edge<T>>& p = _source._graph[next];
+            for (int i = 0; i < (int)p.size(); i++)
+            {
+                if (--deg[p[i].To] == 0)
+                {
+                    sorted[tail++] = p[i].To;
+                }
+            }
+        }
+
+        sorted.resize(tail);
+        return tail == n;
+    }
+
+    bool TryUniqueTopologicalSort(vector<int>& sorted)
+    {
+        int n = _source._vertexCount;
+        sorted.resize(n);
+        vector<int>& deg = ResetDegree();
+
+        int head = 0, tail = 0;
+        for (int i = 0; i < n; i++)
         {
             if (deg[i] == 0)
-                q.push(i);
+                sorted[tail++] = i;
         }
 
-        while (!q.empty())
+        while (head < tail)
         {
-            if ((int)q.size() > 1)
+            if (tail - head > 1)
             {
+                sorted.resize(head);
                 return false;
             }
 
-            int next = q.front();
-            q.pop();
+            int next = sorted[head++];
+
+            vector<Edge<T>>& p = _source._graph[next];
+            for (int i = 0; i < (int)p.size(); i++)
+            {
+                if (--deg[p[i].To] == 0)
+                {
+                    sorted[tail++] = p[i].To;
+                }
+            }
+        }
+
+        sorted.resize(tail);
+        return tail == n;
+    }
+
+    bool TryLexicographicalTopologicalSort(vector<int>& sorted)
+    {
+        int n = _source._vertexCount;
+        sorted.clear();
+        sorted.reserve(n);
+        vector<int>& deg = ResetDegree();
+
+        // min-heap kept in the reusable queue buffer
+        vector<int>& heap = _queue;
+        heap.clear();
+        for (int i = 0; i < n; i++)
+        {
+            if (deg[i] == 0)
+                heap.push_back(i);
+        }
+
+        while (!heap.empty())
+        {
+            pop_heap(heap.begin(), heap.end(), greater<int>());
+            int next = heap.back();
+            heap.pop_back();
 
             sorted.push_back(next);
 
-            vector<Edge<T>>& p = _graph[next];
+            vector<Edge<T>>& p = _source._graph[next];
             for (int i = 0; i < (int)p.size(); i++)
             {
-                deg[p[i].To]--;
-                if (deg[p[i].To] < 0)
+                if (--deg[p[i].To] == 0)
                 {
-                    // detected cycle
-                    return false;
+                    heap.push_back(p[i].To);
+                    push_heap(heap.begin(), heap.end(), greater<int>());
                 }
+            }
+        }
+
+        return (int)sorted.size() == n;
+    }
+
+    // Kahn's algorithm by layers: layers[k] holds the vertices whose longest incoming path has k edges, in increasing
+    // order whatever the thread count. Layers with at least ParallelLayerThreshold vertices are split across the pool.
+    bool TryLayeredTopologicalSort(vector<vector<int>>& layers)
+    {
+        int n = _source._vertexCount;
+        layers.clear();
+        vector<int>& deg = ResetDegree();
+
+        vector<int>& current = _queue;
+        current.clear();
+        for (int i = 0; i < n; i++)
+        {
+            if (deg[i] == 0)
+                current.push_back(i);
+        }
+
+        int emitted = 0;
+        while (!current.empty())
+        {
+            layers.push_back(current);
+            emitted += (int)current.size();
+
+            vector<int>& layer = layers.back();
+            int used = (int)layer.size() < ParallelLayerThreshold ? 1 : _pool.ThreadCount();
 
-                if (deg[p[i].To] == 0)
+            auto relax = [&](int t, int begin, int end)
+            {
+                vector<int>& found = _found[t];
+                found.clear();
+                for (int i = begin; i < end; i++)
                 {
-                    q.push(p[i].To);
+                    vector<Edge<T>>& p = _source._graph[layer[i]];
+                    for (int j = 0; j < (int)p.size(); j++)
+                    {
+                        if (atomic_ref<int>(deg[p[j].To]).fetch_sub(1, memory_order_relaxed) == 1)
+                        {
+                            found.push_back(p[j].To);
+                        }
+                    }
                 }
+            };
+
+            if (used == 1)
+            {
+                relax(0, 0, (int)layer.size());
+            }
+            else
+            {
+                _pool.For((int)layer.size(), relax);
             }
+
+            // which thread finds a vertex depends on timing, so the layer is sorted to keep the output deterministic
+            current.clear();
+            for (int t = 0; t < min(used, (int)layer.size()); t++)
+            {
+                current.insert(current.end(), _found[t].begin(), _found[t].end());
+            }
+            sort(current.begin(), current.end());
         }
 
-        return sorted.size() == _vertexCount;
+        return emitted == n;
     }
 
 private:
-    inline bool Validate(int n)
+    static const int ParallelLayerThreshold = 1 << 14;
+
+    // a working copy of the in-degrees, recounted from the adjacency the sorts walk only when the graph has changed
+    vector<int>& ResetDegree()
     {
-        return 0 <= n && n < _vertexCount;
+        int n = _source._vertexCount;
+        if (_version != _source._version)
+        {
+            _inDegree.assign(n, 0);
+            for (int i = 0; i < n; i++)
+            {
+                for (const Edge<T>& e : _source._graph[i])
+                {
+                    _inDegree[e.To]++;
+                }
+            }
+            _version = _source._version;
+        }
+
+        _degree.assign(_inDegree.begin(), _inDegree.end());
+        return _degree;
     }
-};
\ No newline at end of file
+};
@@ -0,0 +1,311 @@
+// Linear sieve up to max: smallest prime factor, Möbius function and the primes, each found in O(1) per number.
+// Factorization queries walk the smallest-factor table and write into caller buffers, so they do not allocate.
+class Eratosthenes
+{
+private:
+    int _n;
+    vector<uint32_t> _minFactor;
+    vector<int8_t> _mobius;
+    vector<int> _primes;
+    vector<int> _divisorWork;
+
+public:
+    Eratosthenes(int max)
+    {
+        _n = max;
+        _minFactor.assign(max + 1, 0);
+        _mobius.assign(max + 1, 0);
+        if (max >= 1)
+        {
+            _minFactor[1] = 1;
+            _mobius[1] = 1;
+        }
+
+        for (int i = 2; i <= max; i++)
+        {
+            if (_minFactor[i] == 0)
+            {
+                _minFactor[i] = i;
+                _mobius[i] = -1;
+                _primes.push_back(i);
+            }
+
+            // every composite is crossed out once, by its smallest prime factor
+            uint32_t limit = _minFactor[i];
+            for (int p : _primes)
+            {
+                if ((uint32_t)p > limit || (ll)p * i > max) break;
+                _minFactor[p * i] = p;
+                _mobius[p * i] = (uint32_t)p == limit ? 0 : -_mobius[i];
+            }
+        }
+    }
+
+    int Max()
+    {
+        return _n;
+    }
+
+    bool IsPrime(int n)
+    {
+        if (n > _n) throw exception();
+        return n >= 2 && _minFactor[n] == (uint32_t)n;
+    }
+
+    int MinFactor(int n)
+    {
+        if (n > _n) throw exception();
+        return (int)_minFactor[n];
+    }
+
+    int Mobius(int n)
+    {
+        if (n > _n) throw exception();
+        return _mobius[n];
+    }
+
+    vector<int>& Primes()
+    {
+        return _primes;
+    }
+
+    // f(p, c) for each prime power p^c dividing n, in increasing order of p
+    template <typename F>
+    void ForEachPrimeFactor(int n, F f)
+    {
+        if (n > _n) throw exception();
+        while (n > 1)
+        {
+            int p = (int)_minFactor[n];
+            int c = 0;
+            do
+            {
+                n /= p;
+                c++;
+            } while ((int)_minFactor[n] == p);
+
+            f(p, c);
+        }
+    }
+
+    // result is cleared and refilled with (prime, exponent) pairs
+    void PrimeFactorize(int n, vector<pair<int, int>>& result)
+    {
+        result.clear();
+        ForEachPrimeFactor(n, [&](int p, int c)
+        {
+            result.emplace_back(p, c);
+        });
+    }
+
+    // result is cleared and refilled with the divisors of n, in the same order as eratosthenes.cs
+    void GetDivisors(int n, vector<int>& result)
+    {
+        result.clear();
+        result.push_back(1);
+        ForEachPrimeFactor(n, [&](int p, int c)
+        {
+            int length = (int)result.size();
+            for (int j = 0; j < length; j++)
+            {
+                int d = result[j];
+                for (int k = 0; k < c; k++)
+                {
+                    d *= p;
+                    result.push_back(d);
+                }
+            }
+        });
+    }
+
+    // F(n) from f(n) = sum of F(d) over the divisors d of n
+    template <typename T>
+    T MobiusInverse(int n, vector<T>& f)
+    {
+        GetDivisors(n, _divisorWork);
+        T res = 0;
+        for (int d : _divisorWork)
+        {
+            res += T(_mobius[d]) * f[n / d];
+        }
+        return res;
+    }
+};
+
+// Segmented sieve over the mod-30 wheel: each byte holds the 8 residues coprime to 30 in one block of 30 numbers,
+// and the sieve runs over cache-sized segments of bytes. Suited to enumerating primes up to around 10^10.
+class SegmentedSieve
+{
+public:
+    static constexpr int DefaultSegmentBytes = 1 << 15;
+
+    // f(p) for every prime p <= limit in increasing order
+    template <typename F>
+    static void ForEachPrime(ll limit, F f, int segmentBytes = DefaultSegmentBytes)
+    {
+        for (ll p : {2, 3, 5})
+        {
+            if (p <= limit) f(p);
+        }
+
+        Sieve(limit, segmentBytes, [&](const uint8_t* segment, ll firstByte, int length)
+        {
+            int i = 0;
+            for (; i + 8 <= length; i += 8)
+            {
+                uint64_t word;
+                memcpy(&word, segment + i, 8);
+                while (word != 0)
+                {
+                    int bit = __builtin_ctzll(word);
+                    word &= word - 1;
+                    f(30 * (firstByte + i + (bit >> 3)) + Residue(bit & 7));
+                }
+            }
+            for (; i < length; i++)
+            {
+                for (uint32_t bits = segment[i]; bits != 0; bits &= bits - 1)
+                {
+                    f(30 * (firstByte + i) + Residue(__builtin_ctz(bits)));
+                }
+            }
+        });
+    }
+
+    static ll CountPrimes(ll limit, int segmentBytes = DefaultSegmentBytes)
+    {
+        ll count = (limit >= 2) + (limit >= 3) + (limit >= 5);
+        Sieve(limit, segmentBytes, [&](const uint8_t* segment, ll, int length)
+        {
+            int i = 0;
+            for (; i + 8 <= length; i += 8)
+            {
+                uint64_t word;
+                memcpy(&word, segment + i, 8);
+                count += __builtin_popcountll(word);
+            }
+            for (; i < length; i++)
+            {
+                count += __builtin_popcount(segment[i]);
+            }
+        });
+        return count;
+    }
+
+private:
+    static inline int Residue(int bit)
+    {
+        static constexpr int residues[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+        return residues[bit];
+    }
+
+    static inline int BitOf(int residue)
+    {
+        static constexpr int8_t bits[30] = {
+            -1, 0, -1, -1, -1, -1, -1, 1, -1, -1, -1, 2, -1, 3, -1,
+            -1, -1, 4, -1, 5, -1, -1, -1, 6, -1, -1, -1, -1, -1, 7
+        };
+        return bits[residue];
+    }
+
+    // emit(segment, firstByte, length) receives each sieved segment; numbers above limit are already cleared
+    template <typename E>
+    static void Sieve(ll limit, int segmentBytes, E emit)
+    {
+        if (limit < 7)
+        {
+            return;
+        }
+
+        // sieving primes 17 <= p <= sqrt(limit), each with one multiple sequence per wheel residue:
+        // p * (30k + w) lies in byte p * k + p * w / 30 at a bit fixed by p * w mod 30
+        int root = (int)sqrtl((long double)limit);
+        while ((ll)(root + 1) * (root + 1) <= limit) root++;
+        while ((ll)root * root > limit) root--;
+
+        vector<bool> composite(root + 1, false);
+        vector<int> primes;
+        vector<ll> next;
+        vector<uint8_t> masks;
+        for (int p = 2; p <= root; p++)
+        {
+            if (composite[p]) continue;
+            for (ll q = (ll)p * p; q <= root; q += p)
+            {
+                composite[q] = true;
+            }
+            // 7, 11 and 13 are pre-sieved by copying a pattern with period 7 * 11 * 13 bytes
+            if (p < 17) continue;
+
+            primes.push_back(p);
+            for (int j = 0; j < 8; j++)
+            {
+                // the first multiple p * m with m >= p and m = w (mod 30)
+                ll w = Residue(j);
+                ll m = w + (p - w + 29) / 30 * 30;
+                ll multiple = (ll)p * m;
+                next.push_back(multiple / 30);
+                masks.push_back((uint8_t)~(1 << BitOf((int)(multiple % 30))));
+            }
+        }
+
+        const int period = 7 * 11 * 13;
+        vector<uint8_t> pattern(period + segmentBytes);
+        for (int b = 0; b < (int)pattern.size(); b++)
+        {
+            uint8_t bits = 0;
+            for (int bit = 0; bit < 8; bit++)
+            {
+                ll n = 30LL * b + Residue(bit);
+                if (n % 7 != 0 && n % 11 != 0 && n % 13 != 0)
+                {
+                    bits |= (uint8_t)(1 << bit);
+                }
+            }
+            pattern[b] = bits;
+        }
+
+        ll totalBytes = limit / 30 + 1;
+        vector<uint8_t> segment(segmentBytes);
+        for (ll low = 0; low < totalBytes; low += segmentBytes)
+        {
+            int length = (int)min((ll)segmentBytes, totalBytes - low);
+            ll high = low + length;
+            memcpy(segment.data(), pattern.data() + low % period, length);
+
+            for (size_t i = 0; i < primes.size(); i++)
+            {
+                ll p = primes[i];
+                for (int j = 0; j < 8; j++)
+                {
+                    ll byte = next[8 * i + j];
+                    uint8_t mask = masks[8 * i + j];
+                    for (; byte < high; byte += p)
+                    {
+                        segment[byte - low] &= mask;
+                    }
+                    next[8 * i + j] = byte;
+                }
+            }
+
+            if (low == 0)
+            {
+                // 1 is not prime, and 7, 11, 13 were cleared by the pattern
+                segment[0] = (segment[0] & 0xFE) | 0x0E;
+            }
+            if (high == totalBytes)
+            {
+                int last = length - 1;
+                for (int bit = 0; bit < 8; bit++)
+                {
+                    if (30 * (low + last) + Residue(bit) > limit)
+                    {
+                        segment[last] &= (uint8_t)~(1 << bit);
+                    }
+                }
+            }
+
+            emit(segment.data(), low, length);
+        }
+    }
+};
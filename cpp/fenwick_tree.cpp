@@ -0,0 +1,195 @@
+template <typename T>
+class FenwickTree
+{
+private:
+    int _length;
+    int _highBit;
+    vector<T> _tree;
+
+public:
+    FenwickTree(int n)
+    {
+        _length = n;
+        _tree.resize(n + 1, 0);
+        _highBit = 1;
+        while (_highBit * 2 <= n)
+        {
+            _highBit <<= 1;
+        }
+    }
+
+    FenwickTree(vector<T>& array) : FenwickTree((int)array.size())
+    {
+        // O(n): each node pushes its total up to its parent once
+        for (int i = 1; i <= _length; i++)
+        {
+            _tree[i] += array[i - 1];
+            int parent = i + (i & -i);
+            if (parent <= _length)
+            {
+                _tree[parent] += _tree[i];
+            }
+        }
+    }
+
+    int Length()
+    {
+        return _length;
+    }
+
+    void Add(int index, T value)
+    {
+        for (int i = index + 1; i <= _length; i += i & -i)
+        {
+            _tree[i] += value;
+        }
+    }
+
+    // sum of [0, r)
+    T PrefixSum(int r)
+    {
+        T sum = 0;
+        for (int i = r; i > 0; i -= i & -i)
+        {
+            sum += _tree[i];
+        }
+        return sum;
+    }
+
+    T Sum(int l, int r)
+    {
+        return PrefixSum(r) - PrefixSum(l);
+    }
+
+    // smallest i such that the sum of [0, i] is >= sum, or Length() if there is none.
+    // all values must be non-negative.
+    int LowerBound(T sum)
+    {
+        if (sum <= 0)
+        {
+            return 0;
+        }
+
+        int pos = 0;
+        for (int step = _highBit; step > 0; step >>= 1)
+        {
+            if (pos + step <= _length && _tree[pos + step] < sum)
+            {
+                pos += step;
+                sum -= _tree[pos];
+            }
+        }
+
+        return pos;
+    }
+};
+
+// range add / range sum with two Fenwick trees: sum of [0, r) = r * B1(r) - B2(r)
+template <typename T>
+class RangeFenwickTree
+{
+private:
+    int _length;
+    FenwickTree<T> _b1;
+    FenwickTree<T> _b2;
+
+public:
+    RangeFenwickTree(int n) : _b1(n + 1), _b2(n + 1)
+    {
+        _length = n;
+    }
+
+    RangeFenwickTree(vector<T>& array) : _b1((int)array.size() + 1), _b2((int)array.size() + 1)
+    {
+        _length = (int)array.size();
+
+        // a point value v at i is the range add [i, i + 1)
+        vector<T> d1(_length + 1, 0);
+        vector<T> d2(_length + 1, 0);
+        for (int i = 0; i < _length; i++)
+        {
+            d1[i] += array[i];
+            d1[i + 1] -= array[i];
+            d2[i] += array[i] * (T)i;
+            d2[i + 1] -= array[i] * (T)(i + 1);
+        }
+
+        _b1 = FenwickTree<T>(d1);
+        _b2 = FenwickTree<T>(d2);
+    }
+
+    int Length()
+    {
+        return _length;
+    }
+
+    void Add(int l, int r, T value)
+    {
+        _b1.Add(l, value);
+        _b1.Add(r, -value);
+        _b2.Add(l, value * (T)l);
+        _b2.Add(r, -value * (T)r);
+    }
+
+    T PrefixSum(int r)
+    {
+        return _b1.PrefixSum(r) * (T)r - _b2.PrefixSum(r);
+    }
+
+    T Sum(int l, int r)
+    {
+        return PrefixSum(r) - PrefixSum(l);
+    }
+
+    T Get(int index)
+    {
+        return Sum(index, index + 1);
+    }
+};
+
+template <typename T>
+class FenwickTree2D
+{
+private:
+    int _height;
+    int _width;
+    vector<T> _tree;
+
+public:
+    FenwickTree2D(int h, int w)
+    {
+        _height = h;
+        _width = w;
+        _tree.resize((size_t)(h + 1) * (w + 1), 0);
+    }
+
+    void Add(int x, int y, T value)
+    {
+        for (int i = y + 1; i <= _height; i += i & -i)
+        {
+            for (int j = x + 1; j <= _width; j += j & -j)
+            {
+                _tree[(size_t)i * (_width + 1) + j] += value;
+            }
+        }
+    }
+
+    // sum of [0, x) * [0, y)
+    T PrefixSum(int x, int y)
+    {
+        T sum = 0;
+        for (int i = y; i > 0; i -= i & -i)
+        {
+            for (int j = x; j > 0; j -= j & -j)
+            {
+                sum += _tree[(size_t)i * (_width + 1) + j];
+            }
+        }
+        return sum;
+    }
+
+    T Sum(int startX, int startY, int endX, int endY)
+    {
+        return PrefixSum(endX, endY) - PrefixSum(startX, endY) - PrefixSum(endX, startY) + PrefixSum(startX, startY);
+    }
+};
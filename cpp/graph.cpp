@@ -9,6 +9,88 @@ private:
     int _vertexCount;
 
 public:
+    // Adjacency of the complement graph, answered from the sorted original adjacency without materializing it.
+    class ComplementView
+    {
+    private:
+        int _vertexCount;
+        vector<int> _start;
+        vector<int> _adjacent;
+
+    public:
+        ComplementView(vector<vector<Edge<T>>>& graph)
+        {
+            _vertexCount = (int)graph.size();
+            _start.assign(_vertexCount + 1, 0);
+
+            for (int i = 0; i < _vertexCount; i++)
+            {
+                for (int j = 0; j < (int)graph[i].size(); j++)
+                {
+                    _start[graph[i][j].To + 1]++;
+                }
+            }
+
+            for (int i = 0; i < _vertexCount; i++)
+            {
+                _start[i + 1] += _start[i];
+            }
+
+            // the graph is symmetric, so bucketing by the target in source order yields sorted lists
+            vector<int> pos(_start.begin(), _start.end() - 1);
+            _adjacent.resize(_start[_vertexCount]);
+            for (int i = 0; i < _vertexCount; i++)
+            {
+                for (int j = 0; j < (int)graph[i].size(); j++)
+                {
+                    _adjacent[pos[graph[i][j].To]++] = i;
+                }
+            }
+        }
+
+        int VertexCount()
+        {
+            return _vertexCount;
+        }
+
+        bool HasEdge(int a, int b)
+        {
+            return a != b && !binary_search(_adjacent.begin() + _start[a], _adjacent.begin() + _start[a + 1], b);
+        }
+
+        int Degree(int v)
+        {
+            int degree = _vertexCount - 1;
+            for (int i = _start[v]; i < _start[v + 1]; i++)
+            {
+                if (_adjacent[i] != v && (i == _start[v] || _adjacent[i] != _adjacent[i - 1]))
+                {
+                    degree--;
+                }
+            }
+
+            return degree;
+        }
+
+        template <typename F>
+        void ForEachNeighbor(int v, F f)
+        {
+            int i = _start[v];
+            for (int u = 0; u < _vertexCount; u++)
+            {
+                while (i < _start[v + 1] && _adjacent[i] < u)
+                {
+                    i++;
+                }
+
+                if (u != v && (i == _start[v + 1] || _adjacent[i] != u))
+                {
+                    f(u);
+                }
+            }
+        }
+    };
+
     Graph(int vertexCount)
     {
         _vertexCount = vertexCount;
@@ -200,29 +282,24 @@ public:
         }
     }
 
-    Graph<T> CreateComplement() 
+    Graph<T> CreateComplement()
     {
-        struct pair_hash {
-            inline std::size_t operator()(const std::pair<int,int> & v) const {
-                return v.first ^ v.second;
-            }
-        };
-
-        unordered_set<pair<int, int>, pair_hash> edgeSet;
-        for (int i = 0; i < (int)_edges.size(); i++)
-        {
-            edgeSet.emplace(_edges[i].From, _edges[i].To);
-        }
+        vector<int> mark(_vertexCount, -1);
 
         Graph<T> g(_vertexCount);
 
         for (int i = 0; i < _vertexCount - 1; i++)
         {
+            vector<Edge<T>>& ch = _graph[i];
+            for (int j = 0; j < (int)ch.size(); j++)
+            {
+                mark[ch[j].To] = i;
+            }
+
             for (int j = i + 1; j < _vertexCount; j++)
             {
-                if (edgeSet.find(make_pair(i, j)) == edgeSet.end())
+                if (mark[j] != i)
                 {
-                    cout << i << ", " << j << endl;
                     g.AddEdge(i, j, 0);
                 }
             }
@@ -230,7 +307,78 @@ public:
 
         return g;
     }
-    
+
+    ComplementView Complement()
+    {
+        return ComplementView(_graph);
+    }
+
+    void ComplementBfsFrom(int n, vector<int>& map)
+    {
+        if (!Validate(n))
+        {
+            return;
+        }
+
+        fill(map.begin(), map.end(), -1);
+
+        vector<int> next, prev, mark;
+        InitUnvisitedList(next, prev, mark);
+        RemoveUnvisited(n, next, prev);
+
+        vector<int> queue(_vertexCount);
+        int head = 0, tail = 0;
+        queue[tail++] = n;
+        map[n] = 0;
+
+        while (head < tail)
+        {
+            int p = queue[head++];
+            int from = tail;
+            tail = VisitComplement(p, next, prev, mark, queue, tail);
+            for (int i = from; i < tail; i++)
+            {
+                map[queue[i]] = map[p] + 1;
+            }
+        }
+    }
+
+    int ComplementConnectedComponents(vector<int>& ids)
+    {
+        ids.assign(_vertexCount, -1);
+
+        vector<int> next, prev, mark;
+        InitUnvisitedList(next, prev, mark);
+
+        vector<int> queue(_vertexCount);
+        int count = 0;
+
+        while (next[_vertexCount] != _vertexCount)
+        {
+            int s = next[_vertexCount];
+            RemoveUnvisited(s, next, prev);
+
+            int head = 0, tail = 0;
+            queue[tail++] = s;
+            ids[s] = count;
+
+            while (head < tail)
+            {
+                int p = queue[head++];
+                int from = tail;
+                tail = VisitComplement(p, next, prev, mark, queue, tail);
+                for (int i = from; i < tail; i++)
+                {
+                    ids[queue[i]] = count;
+                }
+            }
+
+            count++;
+        }
+
+        return count;
+    }
+
     bool IsBipartite()
     {
         fill(_seen.begin(), _seen.end(), false);
@@ -315,61 +463,257 @@ public:
 
     T MaxSpanningTreeWeight()
     {
-        UnionFind unionFind(_vertexCount);
+        vector<Edge<T>> tree;
+        return MaxSpanningTree(tree);
+    }
 
-        T ans = 0;
+    T MinSpanningTreeWeight()
+    {
+        vector<Edge<T>> tree;
+        return MinSpanningTree(tree);
+    }
+
+    T MaxSpanningTree(vector<Edge<T>>& tree)
+    {
+        return FilterKruskal(tree, greater<T>());
+    }
+
+    T MinSpanningTree(vector<Edge<T>>& tree)
+    {
+        return FilterKruskal(tree, less<T>());
+    }
+
+    T MaxSpanningTreeBoruvka(vector<Edge<T>>& tree, int threadCount = thread::hardware_concurrency())
+    {
+        return Boruvka(tree, threadCount, greater<T>());
+    }
+
+    T MinSpanningTreeBoruvka(vector<Edge<T>>& tree, int threadCount = thread::hardware_concurrency())
+    {
+        return Boruvka(tree, threadCount, less<T>());
+    }
 
-        auto cmp = [](const Edge<T> &a, const Edge<T> &b)
+private:
+    static const int KruskalThreshold = 64;
+
+    inline bool Validate(int n)
+    {
+        return 0 <= n && n < _vertexCount;
+    }
+
+    // doubly linked list of unvisited vertices; index _vertexCount is the sentinel
+    void InitUnvisitedList(vector<int>& next, vector<int>& prev, vector<int>& mark)
+    {
+        next.resize(_vertexCount + 1);
+        prev.resize(_vertexCount + 1);
+        mark.assign(_vertexCount, -1);
+
+        for (int i = 0; i <= _vertexCount; i++)
         {
-            return a.Weight > b.Weight;
-        };
+            next[i] = i == _vertexCount ? 0 : i + 1;
+            prev[i] = i == 0 ? _vertexCount : i - 1;
+        }
+    }
 
-        vector<Edge<T>>& edges = _edges;
+    inline void RemoveUnvisited(int v, vector<int>& next, vector<int>& prev)
+    {
+        next[prev[v]] = next[v];
+        prev[next[v]] = prev[v];
+    }
 
-        sort(edges.begin(), edges.end(), cmp);
+    // moves the unvisited vertices that are not adjacent to p in the original graph onto the queue.
+    // each scanned vertex is either removed or paid for by an edge of p, so the total cost is O(n + m).
+    int VisitComplement(int p, vector<int>& next, vector<int>& prev, vector<int>& mark, vector<int>& queue, int tail)
+    {
+        vector<Edge<T>>& ch = _graph[p];
+        for (int i = 0; i < (int)ch.size(); i++)
+        {
+            mark[ch[i].To] = p;
+        }
 
-        for (int i = 0; i < (int)edges.size(); i++)
+        for (int v = next[_vertexCount]; v != _vertexCount; v = next[v])
         {
-            if (!unionFind.Same(edges[i].From, edges[i].To))
+            if (mark[v] != p)
             {
-                unionFind.Unite(edges[i].From, edges[i].To);
-                ans += edges[i].Weight;
+                RemoveUnvisited(v, next, prev);
+                queue[tail++] = v;
             }
         }
 
-        return ans;
+        return tail;
     }
 
-    T MinSpanningTreeWeight()
+    template <typename Compare>
+    T FilterKruskal(vector<Edge<T>>& tree, Compare cmp)
     {
+        // works on a copy so that _edges keeps the insertion order
+        vector<Edge<T>> edges = _edges;
         UnionFind unionFind(_vertexCount);
 
+        tree.clear();
+        tree.reserve(max(_vertexCount - 1, 0));
+
         T ans = 0;
+        FilterKruskalRec(edges.begin(), edges.end(), unionFind, tree, ans, cmp);
+
+        return ans;
+    }
+
+    template <typename Iter, typename Compare>
+    void FilterKruskalRec(Iter first, Iter last, UnionFind& unionFind, vector<Edge<T>>& tree, T& ans, Compare cmp)
+    {
+        if ((int)tree.size() + 1 >= _vertexCount || first == last)
+        {
+            return;
+        }
 
-        auto cmp = [](const Edge<T> &a, const Edge<T> &b)
+        if (last - first <= KruskalThreshold)
         {
-            return a.Weight < b.Weight;
-        };
+            sort(first, last, [&](const Edge<T>& a, const Edge<T>& b)
+            {
+                return cmp(a.Weight, b.Weight);
+            });
+            KruskalScan(first, last, unionFind, tree, ans);
+            return;
+        }
+
+        T a = first->Weight;
+        T b = (first + (last - first) / 2)->Weight;
+        T c = (last - 1)->Weight;
+        T pivot = cmp(a, b) ? (cmp(b, c) ? b : (cmp(a, c) ? c : a)) : (cmp(a, c) ? a : (cmp(b, c) ? c : b));
+
+        Iter lower = partition(first, last, [&](const Edge<T>& e)
+        {
+            return cmp(e.Weight, pivot);
+        });
+        Iter upper = partition(lower, last, [&](const Edge<T>& e)
+        {
+            return !cmp(pivot, e.Weight);
+        });
 
-        vector<Edge<T>>& edges = _edges;
+        FilterKruskalRec(first, lower, unionFind, tree, ans, cmp);
 
-        sort(edges.begin(), edges.end(), cmp);
+        // every edge in [lower, upper) has the pivot weight, so no sort is needed
+        KruskalScan(lower, upper, unionFind, tree, ans);
 
-        for (int i = 0; i < (int)edges.size(); i++)
+        Iter rest = partition(upper, last, [&](const Edge<T>& e)
         {
-            if (!unionFind.Same(edges[i].From, edges[i].To))
+            return !unionFind.Same(e.From, e.To);
+        });
+
+        FilterKruskalRec(upper, rest, unionFind, tree, ans, cmp);
+    }
+
+    template <typename Iter>
+    void KruskalScan(Iter first, Iter last, UnionFind& unionFind, vector<Edge<T>>& tree, T& ans)
+    {
+        for (Iter it = first; it != last; ++it)
+        {
+            if (!unionFind.Same(it->From, it->To))
             {
-                unionFind.Unite(edges[i].From, edges[i].To);
-                ans += edges[i].Weight;
+                unionFind.Unite(it->From, it->To);
+                ans += it->Weight;
+                tree.push_back(*it);
             }
         }
-
-        return ans;
     }
 
-private:
-    inline bool Validate(int n)
+    template <typename Compare>
+    T Boruvka(vector<Edge<T>>& tree, int threadCount, Compare cmp)
     {
-        return 0 <= n && n < _vertexCount;
+        int edgeCount = (int)_edges.size();
+        threadCount = max(1, threadCount);
+
+        UnionFind unionFind(_vertexCount);
+
+        tree.clear();
+        tree.reserve(max(_vertexCount - 1, 0));
+
+        vector<int> comp(_vertexCount);
+        vector<int> alive(edgeCount);
+        iota(alive.begin(), alive.end(), 0);
+        vector<vector<int>> best(threadCount, vector<int>(_vertexCount));
+        ThreadPool pool(threadCount);
+
+        // ties are broken by edge index so that the picked edges never form a cycle
+        auto better = [&](int x, int y)
+        {
+            if (y < 0) return true;
+            if (cmp(_edges[x].Weight, _edges[y].Weight)) return true;
+            if (cmp(_edges[y].Weight, _edges[x].Weight)) return false;
+            return x < y;
+        };
+
+        T ans = 0;
+
+        while ((int)tree.size() + 1 < _vertexCount)
+        {
+            for (int i = 0; i < _vertexCount; i++)
+            {
+                comp[i] = unionFind.Root(i);
+            }
+
+            int aliveCount = 0;
+            for (int i = 0; i < (int)alive.size(); i++)
+            {
+                if (comp[_edges[alive[i]].From] != comp[_edges[alive[i]].To])
+                {
+                    alive[aliveCount++] = alive[i];
+                }
+            }
+            alive.resize(aliveCount);
+
+            if (aliveCount == 0)
+            {
+                break;
+            }
+
+            pool.For(aliveCount, [&](int t, int begin, int end)
+            {
+                vector<int>& local = best[t];
+                fill(local.begin(), local.end(), -1);
+                for (int i = begin; i < end; i++)
+                {
+                    int e = alive[i];
+                    int u = comp[_edges[e].From];
+                    int v = comp[_edges[e].To];
+                    if (better(e, local[u])) local[u] = e;
+                    if (better(e, local[v])) local[v] = e;
+                }
+            });
+
+            int used = min(threadCount, aliveCount);
+            pool.For(_vertexCount, [&](int, int begin, int end)
+            {
+                for (int i = begin; i < end; i++)
+                {
+                    for (int j = 1; j < used; j++)
+                    {
+                        if (best[j][i] >= 0 && better(best[j][i], best[0][i]))
+                        {
+                            best[0][i] = best[j][i];
+                        }
+                    }
+                }
+            });
+
+            for (int i = 0; i < _vertexCount; i++)
+            {
+                int e = best[0][i];
+                if (comp[i] != i || e < 0)
+                {
+                    continue;
+                }
+
+                if (!unionFind.Same(_edges[e].From, _edges[e].To))
+                {
+                    unionFind.Unite(_edges[e].From, _edges[e].To);
+                    ans += _edges[e].Weight;
+                    tree.push_back(_edges[e]);
+                }
+            }
+        }
+
+        return ans;
     }
 };
\ No newline at end of file
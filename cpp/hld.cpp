@@ -0,0 +1,206 @@
+// Heavy-light decomposition with a lazy segment tree laid over the vertices.
+// OP is assumed to be commutative on path queries, as in hld.cs.
+template <typename T, typename M, T OP(T, T), T MAPPING(T, M, int), M COMPOSITION(M, M)>
+class HeavyLightDecomposition
+{
+private:
+    int _vertexCount;
+    vector<int> _parent;
+    vector<int> _depth;
+    vector<int> _size;
+    vector<int> _root;
+    vector<int> _position;
+    vector<int> _order;
+    LazySegmentTree<T, M, OP, MAPPING, COMPOSITION> _seg;
+    T _identity;
+
+public:
+    template <typename W>
+    HeavyLightDecomposition(Graph<W>& tree, T identity, int root = 0) : _seg(tree.VertexCount(), identity)
+    {
+        _vertexCount = tree.VertexCount();
+        _identity = identity;
+        _parent.assign(_vertexCount, -1);
+        _depth.assign(_vertexCount, 0);
+        _size.assign(_vertexCount, 1);
+        _root.resize(_vertexCount);
+        _position.resize(_vertexCount);
+        _order.reserve(_vertexCount);
+
+        vector<vector<Edge<W>>>& graph = tree.RawGraph();
+
+        // parents and depths in BFS order, then subtree sizes in reverse BFS order
+        vector<int> bfs(_vertexCount);
+        int head = 0, tail = 0;
+        bfs[tail++] = root;
+        while (head < tail)
+        {
+            int v = bfs[head++];
+            for (int i = 0; i < (int)graph[v].size(); i++)
+            {
+                int to = graph[v][i].To;
+                if (to != _parent[v] && to != root && _parent[to] == -1)
+                {
+                    _parent[to] = v;
+                    _depth[to] = _depth[v] + 1;
+                    bfs[tail++] = to;
+                }
+            }
+        }
+
+        vector<int> heavy(_vertexCount, -1);
+        for (int i = tail - 1; i > 0; i--)
+        {
+            int v = bfs[i];
+            int p = _parent[v];
+            _size[p] += _size[v];
+            if (heavy[p] == -1 || _size[heavy[p]] < _size[v])
+            {
+                heavy[p] = v;
+            }
+        }
+
+        // preorder with the heavy child pushed last so that it is visited right after its parent
+        vector<int> stack(_vertexCount);
+        int top = 0;
+        stack[top++] = root;
+        _root[root] = root;
+        while (top > 0)
+        {
+            int v = stack[--top];
+            _position[v] = (int)_order.size();
+            _order.push_back(v);
+
+            for (int i = 0; i < (int)graph[v].size(); i++)
+            {
+                int to = graph[v][i].To;
+                if (_parent[to] == v && to != heavy[v])
+                {
+                    _root[to] = to;
+                    stack[top++] = to;
+                }
+            }
+
+            if (heavy[v] != -1)
+            {
+                _root[heavy[v]] = _root[v];
+                stack[top++] = heavy[v];
+            }
+        }
+    }
+
+    void Build(vector<T>& values)
+    {
+        vector<T> array(_vertexCount);
+        for (int i = 0; i < _vertexCount; i++)
+        {
+            array[_position[i]] = values[i];
+        }
+
+        _seg.Build(array);
+    }
+
+    int VertexCount()
+    {
+        return _vertexCount;
+    }
+
+    int Parent(int v)
+    {
+        return _parent[v];
+    }
+
+    int Depth(int v)
+    {
+        return _depth[v];
+    }
+
+    int SubtreeSize(int v)
+    {
+        return _size[v];
+    }
+
+    int Position(int v)
+    {
+        return _position[v];
+    }
+
+    int Lca(int u, int v)
+    {
+        while (_root[u] != _root[v])
+        {
+            if (_depth[_root[u]] < _depth[_root[v]])
+            {
+                swap(u, v);
+            }
+            u = _parent[_root[u]];
+        }
+
+        return _depth[u] < _depth[v] ? u : v;
+    }
+
+    int Distance(int u, int v)
+    {
+        return _depth[u] + _depth[v] - 2 * _depth[Lca(u, v)];
+    }
+
+    T Get(int v)
+    {
+        return _seg.GetByIndex(_position[v]);
+    }
+
+    // with edge = true the value of each vertex stands for the edge to its parent, and the LCA is excluded.
+    void ApplyPath(int u, int v, M m, bool edge = false)
+    {
+        ForEachPathSegment(u, v, edge, [&](int l, int r)
+        {
+            _seg.Apply(l, r, m);
+        });
+    }
+
+    T QueryPath(int u, int v, bool edge = false)
+    {
+        T res = _identity;
+        ForEachPathSegment(u, v, edge, [&](int l, int r)
+        {
+            res = OP(res, _seg.Query(l, r));
+        });
+
+        return res;
+    }
+
+    void ApplySubtree(int v, M m)
+    {
+        _seg.Apply(_position[v], _position[v] + _size[v], m);
+    }
+
+    T QuerySubtree(int v)
+    {
+        return _seg.Query(_position[v], _position[v] + _size[v]);
+    }
+
+private:
+    template <typename F>
+    void ForEachPathSegment(int u, int v, bool edge, F f)
+    {
+        while (_root[u] != _root[v])
+        {
+            if (_depth[_root[u]] < _depth[_root[v]])
+            {
+                swap(u, v);
+            }
+            f(_position[_root[u]], _position[u] + 1);
+            u = _parent[_root[u]];
+        }
+
+        if (_depth[u] > _depth[v])
+        {
+            swap(u, v);
+        }
+
+        if (_position[u] + (edge ? 1 : 0) < _position[v] + 1)
+        {
+            f(_position[u] + (edge ? 1 : 0), _position[v] + 1);
+        }
+    }
+};
@@ -37,8 +37,168 @@ public:
         }
     }
 
-    vector<T> GetData()
+#ifdef PARALLEL_SCAN
+    // with parallel_scan.cpp
+    void Accumulate(int threadCount, size_t blockSize = ParallelScan::DefaultBlockSize)
+    {
+        ParallelScan::Inclusive(_data.data(), _data.data(), _data.size(), threadCount, blockSize);
+    }
+
+    void Accumulate(ThreadPool& pool, size_t blockSize = ParallelScan::DefaultBlockSize)
+    {
+        ParallelScan::Inclusive(_data.data(), _data.data(), _data.size(), pool, blockSize);
+    }
+#endif
+
+    vector<T>& GetData()
     {
         return _data;
     }
-};
\ No newline at end of file
+};
+
+// Imos over a huge coordinate range: only the interval endpoints are stored, and Accumulate() turns them
+// into runs where the value is constant on [Position(i), Position(i + 1)).
+// The endpoints are kept, so queries may be added after Accumulate() and it may be called again.
+template <typename T>
+class SparseImos
+{
+private:
+    vector<pair<unsigned long long, T>> _events;
+    vector<ll> _positions;
+    vector<T> _values;
+
+public:
+    SparseImos()
+    {
+    }
+
+    SparseImos(int queryCount)
+    {
+        _events.reserve(2 * (size_t)queryCount);
+    }
+
+    void AddQueryLen(ll start, ll length, T value)
+    {
+        AddQuery(start, start + length, value);
+    }
+
+    void AddQuery(ll start, ll end, T value)
+    {
+        _events.emplace_back(EncodeKey(start), value);
+        _events.emplace_back(EncodeKey(end), -value);
+    }
+
+    void Accumulate()
+    {
+        RadixSort();
+
+        _positions.clear();
+        _values.clear();
+
+        T current = 0;
+        for (size_t i = 0; i < _events.size();)
+        {
+            unsigned long long key = _events[i].first;
+            for (; i < _events.size() && _events[i].first == key; i++)
+            {
+                current += _events[i].second;
+            }
+
+            T previous = _values.empty() ? T(0) : _values.back();
+            if (current != previous)
+            {
+                _positions.push_back(DecodeKey(key));
+                _values.push_back(current);
+            }
+        }
+
+    }
+
+    // value at x after Accumulate(): O(log runs)
+    T Get(ll x)
+    {
+        int i = (int)(upper_bound(_positions.begin(), _positions.end(), x) - _positions.begin()) - 1;
+        return i < 0 ? T(0) : _values[i];
+    }
+
+    int RunCount()
+    {
+        return (int)_positions.size();
+    }
+
+    ll Position(int run)
+    {
+        return _positions[run];
+    }
+
+    T Value(int run)
+    {
+        return _values[run];
+    }
+
+    vector<ll>& GetPositions()
+    {
+        return _positions;
+    }
+
+    vector<T>& GetValues()
+    {
+        return _values;
+    }
+
+private:
+    // flips the sign bit so that unsigned order matches signed order
+    static inline unsigned long long EncodeKey(ll x)
+    {
+        return (unsigned long long)x ^ (1ULL << 63);
+    }
+
+    static inline ll DecodeKey(unsigned long long key)
+    {
+        return (ll)(key ^ (1ULL << 63));
+    }
+
+    // LSD radix sort on 8-bit digits; digits shared by every key are skipped
+    void RadixSort()
+    {
+        size_t n = _events.size();
+        if (n <= 1)
+        {
+            return;
+        }
+
+        unsigned long long all = ~0ULL;
+        unsigned long long any = 0;
+        for (auto& e : _events)
+        {
+            all &= e.first;
+            any |= e.first;
+        }
+        unsigned long long varying = all ^ any;
+
+        vector<pair<unsigned long long, T>> buffer(n);
+        for (int shift = 0; shift < 64; shift += 8)
+        {
+            if (((varying >> shift) & 0xFF) == 0)
+            {
+                continue;
+            }
+
+            size_t count[257] = {};
+            for (auto& e : _events)
+            {
+                count[((e.first >> shift) & 0xFF) + 1]++;
+            }
+            for (int d = 0; d < 256; d++)
+            {
+                count[d + 1] += count[d];
+            }
+            for (auto& e : _events)
+            {
+                buffer[count[(e.first >> shift) & 0xFF]++] = e;
+            }
+
+            _events.swap(buffer);
+        }
+    }
+};
@@ -2,39 +2,44 @@ template <typename T>
 class Imos2D
 {
 private:
-    vector<vector<T>> _data;
+    // row-major with stride _width
+    vector<T> _data;
     int _width;
     int _height;
 
 public:
     Imos2D(vector<vector<T>> data)
     {
-        _data = data;
         _height = data.size();
         _width = data[0].size();
+        _data.resize((size_t)_height * _width);
+        for (int y = 0; y < _height; y++)
+        {
+            copy(data[y].begin(), data[y].end(), _data.begin() + (size_t)y * _width);
+        }
     }
 
     Imos2D(int h, int w)
     {
-        _data.resize(h, vector<T>(w, 0));
+        _data.resize((size_t)h * w, 0);
         _width = w;
         _height = h;
     }
 
     void AddQuery(int startX, int startY, int endX, int endY, T value)
     {
-        _data[startY][startX] += value;
+        At(startX, startY) += value;
         if (endX < _width)
         {
-            _data[startY][endX] -= value;
+            At(endX, startY) -= value;
         }
         if (endY < _height)
         {
-            _data[endY][startX] -= value;
+            At(startX, endY) -= value;
         }
         if (endX < _width && endY < _height)
         {
-            _data[endY][endX] += value;
+            At(endX, endY) += value;
         }
     }
 
@@ -45,25 +50,56 @@ public:
 
     void Accumulate()
     {
-        for (int x = 1; x < _width; x++)
+        // both passes walk memory in row order; the second one is a contiguous row-to-row add
+        for (int y = 0; y < _height; y++)
         {
-            for (int y = 0; y < _height; y++)
+            T* row = _data.data() + (size_t)y * _width;
+            for (int x = 1; x < _width; x++)
             {
-                _data[y][x] += _data[y][x - 1];
+                row[x] += row[x - 1];
             }
         }
 
         for (int y = 1; y < _height; y++)
         {
+            T* row = _data.data() + (size_t)y * _width;
+            const T* above = row - _width;
             for (int x = 0; x < _width; x++)
             {
-                _data[y][x] += _data[y - 1][x];
+                row[x] += above[x];
             }
         }
     }
 
-    vector<vector<T>> GetData()
+    T Get(int x, int y)
+    {
+        return _data[(size_t)y * _width + x];
+    }
+
+    span<T> Row(int y)
+    {
+        return span<T>(_data.data() + (size_t)y * _width, _width);
+    }
+
+    // row-major view of the whole grid with stride Width()
+    span<T> GetData()
+    {
+        return span<T>(_data);
+    }
+
+    int Width()
+    {
+        return _width;
+    }
+
+    int Height()
+    {
+        return _height;
+    }
+
+private:
+    inline T& At(int x, int y)
     {
-        return _data;
+        return _data[(size_t)y * _width + x];
     }
-};
\ No newline at end of file
+};
@@ -1,4 +1,4 @@
-template <typename T, typename M, T OP(T, T), T MAPPING(T, M, int), T COMPOSITION(T, T)>
+template <typename T, typename M, T OP(T, T), T MAPPING(T, M, int), M COMPOSITION(M, M)>
 class LazySegmentTree
 {
 private:
@@ -6,7 +6,7 @@ private:
     int _dataSize;
     int _originalDataSize;
     vector<T> _data;
-    vector<optional<T>> _lazy;
+    vector<optional<M>> _lazy;
     T _identity;
 
 public:
@@ -70,7 +70,7 @@ public:
     {
         if (index < 0 || index >= _originalDataSize)
         {
-            throw exception("index");
+            throw exception();
         }
 
         return AccessRec(index, 0, 0, _dataSize);
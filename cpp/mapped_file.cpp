@@ -0,0 +1,73 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Read-only memory mapping of a whole file (POSIX).
+class MappedFile
+{
+private:
+    int _fd;
+    const char* _data;
+    ll _size;
+
+public:
+    MappedFile(const string& path)
+    {
+        _fd = open(path.c_str(), O_RDONLY);
+        if (_fd < 0)
+        {
+            throw exception();
+        }
+
+        struct stat st;
+        if (fstat(_fd, &st) != 0)
+        {
+            close(_fd);
+            throw exception();
+        }
+
+        _size = (ll)st.st_size;
+        _data = nullptr;
+
+        if (_size > 0)
+        {
+            void* p = mmap(nullptr, (size_t)_size, PROT_READ, MAP_PRIVATE, _fd, 0);
+            if (p == MAP_FAILED)
+            {
+                close(_fd);
+                throw exception();
+            }
+
+            madvise(p, (size_t)_size, MADV_SEQUENTIAL);
+            _data = (const char*)p;
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile()
+    {
+        if (_data != nullptr)
+        {
+            munmap((void*)_data, (size_t)_size);
+        }
+        close(_fd);
+    }
+
+    const char* Data()
+    {
+        return _data;
+    }
+
+    ll Size()
+    {
+        return _size;
+    }
+
+    string_view View()
+    {
+        return string_view(_data, (size_t)_size);
+    }
+};
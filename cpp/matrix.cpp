@@ -0,0 +1,368 @@
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Semirings for Matrix: Zero is the additive identity and the fill value, One the multiplicative identity.
+template <typename T>
+struct ArithmeticSemiring
+{
+    static T Zero() { return T(0); }
+    static T One() { return T(1); }
+    static T Add(T a, T b) { return a + b; }
+    static T Mul(T a, T b) { return a * b; }
+};
+
+// shortest paths: Zero is +infinity, and infinity absorbs in Mul
+template <typename T>
+struct MinPlusSemiring
+{
+    static T Zero() { return numeric_limits<T>::max(); }
+    static T One() { return T(0); }
+    static T Add(T a, T b) { return min(a, b); }
+    static T Mul(T a, T b) { return a == Zero() || b == Zero() ? Zero() : a + b; }
+};
+
+// longest paths: Zero is -infinity, and infinity absorbs in Mul
+template <typename T>
+struct MaxPlusSemiring
+{
+    static T Zero() { return numeric_limits<T>::lowest(); }
+    static T One() { return T(0); }
+    static T Add(T a, T b) { return max(a, b); }
+    static T Mul(T a, T b) { return a == Zero() || b == Zero() ? Zero() : a + b; }
+};
+
+// Dense rows x cols matrix over the semiring S, stored row-major in one buffer.
+// With CONST_MOD defined, Matrix<ModInt> multiplies through 64-bit accumulators that are reduced lazily
+// (see MultiplyLazy); other semirings use a plain i-k-j loop.
+template <typename T, typename S = ArithmeticSemiring<T>>
+class Matrix
+{
+private:
+    int _rows;
+    int _cols;
+    vector<T> _data;
+
+public:
+    // column tile of the generic multiply kernel
+    static constexpr int TileWidth = 512;
+    static constexpr int LazyDepth = 8;
+
+    // the narrowed, padded copies of both sides taken by the lazy ModInt multiply; reusing one across
+    // multiplies (as Power does) keeps their buffers. Unused by other semirings.
+    struct MultiplyScratch
+    {
+        vector<uint32_t> Left;
+        vector<uint32_t> Right;
+    };
+
+    Matrix() : Matrix(0, 0)
+    {
+    }
+
+    explicit Matrix(int size) : Matrix(size, size)
+    {
+    }
+
+    Matrix(int rows, int cols)
+    {
+        _rows = rows;
+        _cols = cols;
+        _data.assign((size_t)rows * cols, S::Zero());
+    }
+
+    static Matrix Identity(int size)
+    {
+        Matrix res(size);
+        for (int i = 0; i < size; i++)
+        {
+            res(i, i) = S::One();
+        }
+        return res;
+    }
+
+    int Rows() const
+    {
+        return _rows;
+    }
+
+    int Cols() const
+    {
+        return _cols;
+    }
+
+    T& operator()(int r, int c)
+    {
+        return _data[(size_t)r * _cols + c];
+    }
+
+    const T& operator()(int r, int c) const
+    {
+        return _data[(size_t)r * _cols + c];
+    }
+
+    span<T> Row(int r)
+    {
+        return span<T>(_data.data() + (size_t)r * _cols, _cols);
+    }
+
+    span<T> GetData()
+    {
+        return span<T>(_data);
+    }
+
+    friend Matrix operator+(const Matrix& left, const Matrix& right)
+    {
+        if (left._rows != right._rows || left._cols != right._cols)
+        {
+            throw exception();
+        }
+
+        Matrix dest(left._rows, left._cols);
+        for (size_t i = 0; i < dest._data.size(); i++)
+        {
+            dest._data[i] = S::Add(left._data[i], right._data[i]);
+        }
+        return dest;
+    }
+
+    // only meaningful for rings
+    friend Matrix operator-(const Matrix& left, const Matrix& right)
+    {
+        if (left._rows != right._rows || left._cols != right._cols)
+        {
+            throw exception();
+        }
+
+        Matrix dest(left._rows, left._cols);
+        for (size_t i = 0; i < dest._data.size(); i++)
+        {
+            dest._data[i] = left._data[i] - right._data[i];
+        }
+        return dest;
+    }
+
+    friend Matrix operator*(const Matrix& left, const Matrix& right)
+    {
+        Matrix dest;
+        Multiply(left, right, dest);
+        return dest;
+    }
+
+    Matrix& operator*=(const Matrix& right)
+    {
+        Matrix dest;
+        Multiply(*this, right, dest);
+        swap(*this, dest);
+        return *this;
+    }
+
+    // dest = left * right; dest keeps its buffer when the shape already fits and must not alias either side
+    static void Multiply(const Matrix& left, const Matrix& right, Matrix& dest)
+    {
+        MultiplyScratch scratch;
+        Multiply(left, right, dest, scratch);
+    }
+
+    static void Multiply(const Matrix& left, const Matrix& right, Matrix& dest, MultiplyScratch& scratch)
+    {
+        if (left._cols != right._rows)
+        {
+            throw exception();
+        }
+
+        dest._rows = left._rows;
+        dest._cols = right._cols;
+        dest._data.resize((size_t)dest._rows * dest._cols);
+
+#ifdef CONST_MOD
+        if constexpr (is_same_v<T, ModInt> && is_same_v<S, ArithmeticSemiring<T>>)
+        {
+            MultiplyLazy(left, right, dest, scratch);
+            return;
+        }
+#endif
+
+        int n = left._rows, m = left._cols, p = right._cols;
+        for (int j0 = 0; j0 < p; j0 += TileWidth)
+        {
+            int j1 = min(p, j0 + TileWidth);
+            for (int i = 0; i < n; i++)
+            {
+                T* out = dest._data.data() + (size_t)i * p;
+                fill(out + j0, out + j1, S::Zero());
+
+                const T* a = left._data.data() + (size_t)i * m;
+                for (int k = 0; k < m; k++)
+                {
+                    T x = a[k];
+                    const T* b = right._data.data() + (size_t)k * p;
+                    for (int j = j0; j < j1; j++)
+                    {
+                        out[j] = S::Add(out[j], S::Mul(x, b[j]));
+                    }
+                }
+            }
+        }
+    }
+
+    // square matrices only; three buffers and the multiply scratch are reused across all squarings
+    Matrix Power(ll exp) const
+    {
+        if (_rows != _cols)
+        {
+            throw exception();
+        }
+
+        Matrix res = Identity(_rows);
+        Matrix base = *this;
+        Matrix temp(_rows);
+        MultiplyScratch scratch;
+        while (exp > 0)
+        {
+            if (exp & 1)
+            {
+                Multiply(res, base, temp, scratch);
+                swap(res, temp);
+            }
+
+            exp >>= 1;
+            if (exp > 0)
+            {
+                Multiply(base, base, temp, scratch);
+                swap(base, temp);
+            }
+        }
+
+        return res;
+    }
+
+private:
+#ifdef CONST_MOD
+    // ModInt(long long) does not normalize, so entries may be negative or at least CONST_MOD
+    static inline uint32_t Narrow(const ModInt& x)
+    {
+        ll v = x.Value % CONST_MOD;
+        return (uint32_t)(v < 0 ? v + CONST_MOD : v);
+    }
+
+    // 4 x 8 register tiles of 64-bit accumulators over both sides narrowed to 32 bits, so that every product is
+    // one 32x32->64 multiply. After every LazyDepth products the accumulators drop below
+    // bound = LazyDepth * CONST_MOD^2 by one conditional subtraction, and % is taken once per entry at the end.
+    // a column panel of the right side is reused by every row tile before moving on.
+    static void MultiplyLazy(const Matrix& left, const Matrix& right, Matrix& dest, MultiplyScratch& scratch)
+    {
+        const int tileRows = 4, tileCols = 8;
+        const uint64_t bound = (uint64_t)LazyDepth * CONST_MOD * CONST_MOD;
+        static_assert((unsigned __int128)2 * LazyDepth * CONST_MOD * CONST_MOD <= ~0ULL);
+
+        int n = left._rows, m = left._cols, p = right._cols;
+        int paddedRows = (n + tileRows - 1) / tileRows * tileRows;
+        int paddedCols = (p + tileCols - 1) / tileCols * tileCols;
+
+        // every entry is rewritten, so resize only allocates when a side outgrows the scratch
+        vector<uint32_t>& a = scratch.Left;
+        a.resize((size_t)paddedRows * m);
+        for (size_t i = 0; i < left._data.size(); i++)
+        {
+            a[i] = Narrow(left._data[i]);
+        }
+        fill(a.begin() + left._data.size(), a.end(), 0);
+
+        vector<uint32_t>& b = scratch.Right;
+        b.resize((size_t)m * paddedCols);
+        for (int k = 0; k < m; k++)
+        {
+            uint32_t* row = b.data() + (size_t)k * paddedCols;
+            for (int j = 0; j < p; j++)
+            {
+                row[j] = Narrow(right._data[(size_t)k * p + j]);
+            }
+            fill(row + p, row + paddedCols, 0);
+        }
+
+        for (int j0 = 0; j0 < paddedCols; j0 += tileCols)
+        {
+            for (int i0 = 0; i0 < paddedRows; i0 += tileRows)
+            {
+                uint64_t c[tileRows][tileCols] = {};
+#if defined(__AVX2__)
+                // accumulators for row r are acc[2r] (columns 0-3) and acc[2r + 1] (columns 4-7)
+                __m256i acc[2 * tileRows];
+                for (int q = 0; q < 2 * tileRows; q++)
+                {
+                    acc[q] = _mm256_setzero_si256();
+                }
+                // unsigned compare through the signed one: flip the sign bits of both sides
+                const __m256i sign = _mm256_set1_epi64x((ll)(1ULL << 63));
+                const __m256i limit = _mm256_set1_epi64x((ll)((bound - 1) ^ (1ULL << 63)));
+                const __m256i boundVec = _mm256_set1_epi64x((ll)bound);
+
+                for (int k0 = 0; k0 < m; k0 += LazyDepth)
+                {
+                    int k1 = min(m, k0 + LazyDepth);
+                    for (int k = k0; k < k1; k++)
+                    {
+                        const uint32_t* row = b.data() + (size_t)k * paddedCols + j0;
+                        __m256i low = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)row));
+                        __m256i high = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(row + 4)));
+                        for (int r = 0; r < tileRows; r++)
+                        {
+                            __m256i x = _mm256_set1_epi64x(a[(size_t)(i0 + r) * m + k]);
+                            acc[2 * r] = _mm256_add_epi64(acc[2 * r], _mm256_mul_epu32(x, low));
+                            acc[2 * r + 1] = _mm256_add_epi64(acc[2 * r + 1], _mm256_mul_epu32(x, high));
+                        }
+                    }
+
+                    for (int q = 0; q < 2 * tileRows; q++)
+                    {
+                        __m256i over = _mm256_cmpgt_epi64(_mm256_xor_si256(acc[q], sign), limit);
+                        acc[q] = _mm256_sub_epi64(acc[q], _mm256_and_si256(over, boundVec));
+                    }
+                }
+
+                for (int r = 0; r < tileRows; r++)
+                {
+                    _mm256_storeu_si256((__m256i*)c[r], acc[2 * r]);
+                    _mm256_storeu_si256((__m256i*)(c[r] + 4), acc[2 * r + 1]);
+                }
+#else
+                for (int k0 = 0; k0 < m; k0 += LazyDepth)
+                {
+                    int k1 = min(m, k0 + LazyDepth);
+                    for (int k = k0; k < k1; k++)
+                    {
+                        const uint32_t* row = b.data() + (size_t)k * paddedCols + j0;
+                        for (int r = 0; r < tileRows; r++)
+                        {
+                            uint64_t x = a[(size_t)(i0 + r) * m + k];
+                            for (int t = 0; t < tileCols; t++)
+                            {
+                                c[r][t] += x * row[t];
+                            }
+                        }
+                    }
+
+                    // c stays below 2 * bound, and bound is a multiple of CONST_MOD
+                    for (int r = 0; r < tileRows; r++)
+                    {
+                        for (int t = 0; t < tileCols; t++)
+                        {
+                            c[r][t] -= c[r][t] >= bound ? bound : 0;
+                        }
+                    }
+                }
+#endif
+
+                for (int r = 0; r < tileRows && i0 + r < n; r++)
+                {
+                    for (int t = 0; t < tileCols && j0 + t < p; t++)
+                    {
+                        dest._data[(size_t)(i0 + r) * p + j0 + t] = ModInt((ll)(c[r][t] % CONST_MOD));
+                    }
+                }
+            }
+        }
+    }
+#endif
+};
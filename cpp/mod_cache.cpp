@@ -1,50 +1,247 @@
+// Factorials and inverse factorials modulo CONST_MOD, stored as 32-bit values; Inverse(n) is read off both.
+// The tables grow geometrically when an argument goes past them, so max is only a first size.
 class ModCache
 {
 private:
-    vector<ModInt> _factorial;
-    vector<ModInt> _inverseFactorial;
-    vector<ModInt> _inverse;
+    vector<uint32_t> _factorial;
+    vector<uint32_t> _inverseFactorial;
 
 public:
-    ModCache(int max)
+    // moduli up to this size let Lucas grow the tables to CONST_MOD - 1 entries
+    static constexpr int LucasTableLimit = 1 << 22;
+
+    ModCache(int max = 0)
     {
-        _factorial.resize(max + 1);
-        _inverseFactorial.resize(max + 1);
-        _inverse.resize(max + 1);
+        _factorial.push_back(1);
+        _inverseFactorial.push_back(1);
+
+        Grow(max);
+    }
+
+    // n >= CONST_MOD goes through Lucas
+    ModInt Combination(int n, int r)
+    {
+        if (n < 0 || r < 0 || n < r) return 0;
+        if (n >= CONST_MOD) return Lucas(n, r);
+        Reserve(n);
+        return ModInt(Mul(_factorial[n], Mul(_inverseFactorial[n - r], _inverseFactorial[r])));
+    }
+
+    // C(n, r) for huge n and r < CONST_MOD: O(r) multiplications and no inverse beyond the table; throws for larger r
+    ModInt CombinationLargeN(long long n, int r)
+    {
+        if (r < 0 || n < r) return 0;
+        Reserve(r);
+
+        uint64_t numerator = 1;
+        for (int k = 0; k < r; k++)
+        {
+            numerator = Mul(numerator, (uint64_t)((n - k) % CONST_MOD));
+        }
+        return ModInt(Mul(numerator, _inverseFactorial[r]));
+    }
 
-        _factorial[0] = 1;
-        _inverseFactorial[0] = 1LL;
-        _inverse[1] = 1LL;
+    // Lucas' theorem. A digit is looked up in the tables when they already cover it or CONST_MOD is at most
+    // LucasTableLimit; otherwise it is a direct product of min(r, n - r) terms, so a large modulus never grows the
+    // tables toward CONST_MOD entries.
+    ModInt Lucas(long long n, long long r)
+    {
+        if (r < 0 || n < r) return 0;
 
-        for (long p = 1; p <= max; p++)
+        uint64_t c = 1;
+        while (r > 0)
         {
-            _factorial[p] = _factorial[p - 1] * p;
-            if (p > 1)
+            int nd = (int)(n % CONST_MOD);
+            int rd = (int)(r % CONST_MOD);
+            if (rd > nd) return 0;
+
+            if (nd < Size() || CONST_MOD <= LucasTableLimit)
+            {
+                Reserve(nd);
+                c = Mul(c, Mul(_factorial[nd], Mul(_inverseFactorial[nd - rd], _inverseFactorial[rd])));
+            }
+            else
             {
-                _inverse[p] = -(CONST_MOD / p) * _inverse[CONST_MOD % p];
+                c = Mul(c, (uint64_t)ModInt::Combination(nd, rd).Value);
             }
-            _inverseFactorial[p] = _inverseFactorial[p - 1] * _inverse[p];
+            n /= CONST_MOD;
+            r /= CONST_MOD;
         }
+        return ModInt(c);
     }
 
-    ModInt Combination(int n, int r)
+    // out[i] = Combination(ns[i], rs[i]) for ns[i] < CONST_MOD; the tables are grown once and the lookups are prefetched ahead
+    void CombinationBatch(span<const int> ns, span<const int> rs, span<ModInt> out)
     {
-        if (n < 0 || r < 0 || n < r) return 0;
-        return _factorial[n] * (_inverseFactorial[n - r] * _inverseFactorial[r]);
+        const int distance = 16;
+        int count = (int)ns.size();
+        if (count == 0)
+        {
+            return;
+        }
+        Reserve(*max_element(ns.begin(), ns.end()));
+
+        const uint32_t* factorial = _factorial.data();
+        const uint32_t* inverseFactorial = _inverseFactorial.data();
+        for (int i = 0; i < count; i++)
+        {
+            if (i + distance < count && rs[i + distance] >= 0 && rs[i + distance] <= ns[i + distance])
+            {
+                __builtin_prefetch(factorial + ns[i + distance]);
+                __builtin_prefetch(inverseFactorial + rs[i + distance]);
+                __builtin_prefetch(inverseFactorial + (ns[i + distance] - rs[i + distance]));
+            }
+
+            int n = ns[i];
+            int r = rs[i];
+            if (n < 0 || r < 0 || n < r)
+            {
+                out[i] = 0;
+                continue;
+            }
+            out[i] = ModInt(Mul(factorial[n], Mul(inverseFactorial[n - r], inverseFactorial[r])));
+        }
     }
 
     ModInt Permutation(int n, int r)
     {
-        return _factorial[n] * _inverseFactorial[n - r];
+        Reserve(n);
+        return ModInt(Mul(_factorial[n], _inverseFactorial[n - r]));
     }
 
     ModInt Factorial(int n)
     {
-        return _factorial[n];
+        Reserve(n);
+        return ModInt(_factorial[n]);
+    }
+
+    ModInt InverseFactorial(int n)
+    {
+        Reserve(n);
+        return ModInt(_inverseFactorial[n]);
     }
 
+    // 1 / n = (n - 1)! / n!; 0 for n = 0
     ModInt Inverse(int n)
     {
-        return _inverse[n];
+        if (n == 0) return 0;
+        Reserve(n);
+        return ModInt(Mul(_inverseFactorial[n], _factorial[n - 1]));
+    }
+
+    // makes every table cover [0, n]; past CONST_MOD - 1 the factorials are 0 and have no inverse
+    void Reserve(int n)
+    {
+        if (n >= CONST_MOD)
+        {
+            throw exception();
+        }
+
+        int size = (int)_factorial.size();
+        if (n >= size)
+        {
+            Grow((int)min(max((long long)n, 2LL * size - 1), (long long)CONST_MOD - 1));
+        }
+    }
+
+    int Size()
+    {
+        return (int)_factorial.size();
+    }
+
+private:
+    static inline uint32_t Mul(uint64_t a, uint64_t b)
+    {
+        return (uint32_t)(a * b % CONST_MOD);
+    }
+
+    // extends the tables to [0, max] with one modular inverse: the inverse factorials are filled backwards from max.
+    // both product chains are split into Lanes interleaved segments so that their multiplications overlap.
+    void Grow(int max)
+    {
+        const int Lanes = 4;
+
+        int old = (int)_factorial.size();
+        if (max < old)
+        {
+            return;
+        }
+
+        _factorial.resize(max + 1);
+        _inverseFactorial.resize(max + 1);
+
+        int chunk = (max + 1 - old) / Lanes;
+        if (chunk < 64)
+        {
+            for (int i = old; i <= max; i++)
+            {
+                _factorial[i] = Mul(_factorial[i - 1], (uint64_t)i);
+            }
+
+            _inverseFactorial[max] = (uint32_t)ModInt(_factorial[max]).Inv().Value;
+            for (int i = max; i > old; i--)
+            {
+                _inverseFactorial[i - 1] = Mul(_inverseFactorial[i], (uint64_t)i);
+            }
+        }
+        else
+        {
+            // lane k covers [start[k], start[k] + chunk); the last lane also takes the remainder up to max
+            int start[Lanes];
+            uint64_t product[Lanes];
+            for (int k = 0; k < Lanes; k++)
+            {
+                start[k] = old + k * chunk;
+                product[k] = 1;
+            }
+            product[0] = _factorial[old - 1];
+
+            for (int j = 0; j < chunk; j++)
+            {
+                for (int k = 0; k < Lanes; k++)
+                {
+                    product[k] = Mul(product[k], (uint64_t)(start[k] + j));
+                    _factorial[start[k] + j] = (uint32_t)product[k];
+                }
+            }
+            for (int i = start[Lanes - 1] + chunk; i <= max; i++)
+            {
+                product[Lanes - 1] = Mul(product[Lanes - 1], (uint64_t)i);
+                _factorial[i] = (uint32_t)product[Lanes - 1];
+            }
+
+            // lanes after the first hold products of their own segment only
+            for (int k = 1; k < Lanes; k++)
+            {
+                uint64_t offset = _factorial[start[k] - 1];
+                int end = k + 1 < Lanes ? start[k + 1] : max + 1;
+                for (int i = start[k]; i < end; i++)
+                {
+                    _factorial[i] = Mul(_factorial[i], offset);
+                }
+            }
+
+            // 1 / (start[k + 1] - 1)! = 1 / max! * (products of the segments after lane k)
+            _inverseFactorial[max] = (uint32_t)ModInt(_factorial[max]).Inv().Value;
+            uint64_t suffix = _inverseFactorial[max];
+            for (int k = Lanes - 2; k >= 0; k--)
+            {
+                suffix = Mul(suffix, product[k + 1]);
+                _inverseFactorial[start[k + 1] - 1] = (uint32_t)suffix;
+            }
+
+            for (int i = max; i >= start[Lanes - 1] + chunk; i--)
+            {
+                _inverseFactorial[i - 1] = Mul(_inverseFactorial[i], (uint64_t)i);
+            }
+
+            for (int j = chunk - 1; j > 0; j--)
+            {
+                for (int k = 0; k < Lanes; k++)
+                {
+                    _inverseFactorial[start[k] + j - 1] = Mul(_inverseFactorial[start[k] + j], (uint64_t)(start[k] + j));
+                }
+            }
+        }
     }
-};
\ No newline at end of file
+};
@@ -211,17 +211,48 @@ public:
         return ModInt(1L);
     }
 
+    // Lucas' theorem over the base-CONST_MOD digits, so n may be huge. Each digit costs O(min(r, CONST_MOD))
+    // multiplications and one inverse; for r < CONST_MOD that is a single digit.
+    // negative n gives the generalized binomial n (n - 1) ... (n - r + 1) / r! = (-1)^r C(r - n - 1, r).
     static ModInt Combination(long long n, long long r)
     {
+        if (r < 0) return 0;
+        if (n < 0)
+        {
+            ModInt c = Combination(r - n - 1, r);
+            return r % 2 == 0 ? c : ModInt(0L) - c;
+        }
+        if (n < r) return 0;
+
+        r = min(r, n - r);
         ModInt c = 1L;
-        for (ModInt i = 1; i.Value <= r; i++)
+        while (r > 0)
         {
-            c = c * (ModInt(n) - i + ModInt::One()) / i;
+            long long nd = n % CONST_MOD;
+            long long rd = r % CONST_MOD;
+            if (rd > nd) return 0;
+
+            c *= CombinationDigit(nd, min(rd, nd - rd));
+            n /= CONST_MOD;
+            r /= CONST_MOD;
         }
         return c;
     }
 
 private:
+    // 0 <= r <= n < CONST_MOD
+    static ModInt CombinationDigit(long long n, long long r)
+    {
+        ModInt numerator = 1L;
+        ModInt denominator = 1L;
+        for (long long k = 0; k < r; k++)
+        {
+            numerator *= n - k;
+            denominator *= k + 1;
+        }
+        return numerator * denominator.Inv();
+    }
+
     inline static long long SafeMod(long long a)
     {
         a %= CONST_MOD;
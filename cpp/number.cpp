@@ -1,3 +1,75 @@
+// Montgomery multiplication modulo an odd n < 2^63; values are kept in Montgomery form x * 2^64 mod n.
+class Montgomery64
+{
+private:
+    uint64_t _mod;
+    uint64_t _inverse;
+    uint64_t _r2;
+
+public:
+    Montgomery64(uint64_t mod)
+    {
+        _mod = mod;
+
+        // mod * mod = 1 (mod 8), and each Newton step doubles the correct low bits: 3 -> 6 -> ... -> 96
+        _inverse = mod;
+        for (int i = 0; i < 5; i++)
+        {
+            _inverse *= 2 - mod * _inverse;
+        }
+
+        // 2^128 mod n
+        _r2 = (uint64_t)(-(__uint128_t)mod % mod);
+    }
+
+    inline uint64_t Mod() const
+    {
+        return _mod;
+    }
+
+    // t < mod * 2^64; returns t / 2^64 mod n in [0, n)
+    inline uint64_t Reduce(__uint128_t t) const
+    {
+        uint64_t m = (uint64_t)t * _inverse;
+        uint64_t high = (uint64_t)(t >> 64);
+        uint64_t mn = (uint64_t)(((__uint128_t)m * _mod) >> 64);
+        return high >= mn ? high - mn : high - mn + _mod;
+    }
+
+    inline uint64_t Mul(uint64_t a, uint64_t b) const
+    {
+        return Reduce((__uint128_t)a * b);
+    }
+
+    inline uint64_t Add(uint64_t a, uint64_t b) const
+    {
+        uint64_t s = a + b;
+        return s >= _mod ? s - _mod : s;
+    }
+
+    inline uint64_t To(uint64_t a) const
+    {
+        return Mul(a % _mod, _r2);
+    }
+
+    inline uint64_t From(uint64_t a) const
+    {
+        return Reduce(a);
+    }
+
+    uint64_t Power(uint64_t a, uint64_t exp) const
+    {
+        uint64_t res = To(1);
+        while (exp > 0)
+        {
+            if (exp & 1) res = Mul(res, a);
+            a = Mul(a, a);
+            exp >>= 1;
+        }
+        return res;
+    }
+};
+
 class Number
 {
 public:
@@ -9,30 +81,43 @@ public:
         return x;
     }
 
+    // a * p + b * q = gcd(a, b), without recursion
     static ll ExtEuclid(ll a, ll b, ll& p, ll& q)
     {
-        if (b == 0)
+        ll p0 = 1, p1 = 0;
+        ll q0 = 0, q1 = 1;
+        while (b != 0)
         {
-            p = 1;
-            q = 0;
-            return a;
+            ll t = a / b;
+            a -= t * b;
+            swap(a, b);
+            p0 -= t * p1;
+            swap(p0, p1);
+            q0 -= t * q1;
+            swap(q0, q1);
         }
-        ll d = ExtEuclid(b, a % b, q, p);
-        q -= a / b * p;
-        return d;
+
+        p = p0;
+        q = q0;
+        return a;
     }
 
+    // (r, lcm) with r = x1 (mod m1) and r = x2 (mod m2), or (0, -1) if there is none.
+    // intermediate products are taken in __int128, so any result whose lcm fits in ll is exact.
     static pair<ll, ll> CRT(ll x1, ll m1, ll x2, ll m2)
     {
+        x1 = SafeMod(x1, m1);
+        x2 = SafeMod(x2, m2);
+
         ll p, q;
         ll d = ExtEuclid(m1, m2, p, q);
         if ((x2 - x1) % d != 0)
             return make_pair(0, -1);
 
-        ll m = m1 * (m2 / d);
-        ll temp = (x2 - x1) / d * p % (m2 / d);
-        ll r = SafeMod(x1 + m1 * temp, m);
-        return make_pair(r, m);
+        // x1 + m1 * temp < m1 * step, so the result needs no final reduction
+        ll step = m2 / d;
+        ll temp = (ll)((__int128)SafeMod((x2 - x1) / d, step) * SafeMod(p, step) % step);
+        return make_pair((ll)((__int128)x1 + (__int128)m1 * temp), m1 * step);
     }
 
     static pair<ll, ll> CRT(vector<ll>& x, vector<ll>& mod)
@@ -40,15 +125,305 @@ public:
         ll r = 0, m = 1;
         for (int i = 0; i < (int)x.size(); i++)
         {
+            ll mi = mod[i];
+            ll xi = SafeMod(x[i], mi);
+            if (m < mi)
+            {
+                swap(m, mi);
+                swap(r, xi);
+            }
+            if (m % mi == 0)
+            {
+                if (r % mi != xi)
+                    return make_pair(0, -1);
+                continue;
+            }
+
             ll p, q;
-            ll d = ExtEuclid(m, mod[i], p, q);
-            if ((x[i] - r) % d != 0)
+            ll d = ExtEuclid(m, mi, p, q);
+            if ((xi - r) % d != 0)
                 return make_pair(0, -1);
-            ll temp = (x[i] - r) / d * p % (mod[i] / d);
-            r += m * temp;
-            m *= mod[i] / d;
+
+            ll step = mi / d;
+            ll temp = (ll)((__int128)SafeMod((xi - r) / d, step) * SafeMod(p, step) % step);
+            r = (ll)((__int128)r + (__int128)m * temp);
+            m *= step;
         }
 
         return make_pair(SafeMod(r, m), m);
     }
-};
\ No newline at end of file
+
+    // deterministic Miller-Rabin for every 64-bit n, with the 7-witness set of Jim Sinclair
+    static bool IsPrime(ll n)
+    {
+        if (n < 2) return false;
+        for (ll p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37})
+        {
+            if (n % p == 0) return n == p;
+        }
+        if (n < 41 * 41) return true;
+
+        Montgomery64 mont(n);
+        uint64_t d = n - 1;
+        int s = __builtin_ctzll(d);
+        d >>= s;
+
+        uint64_t one = mont.To(1);
+        uint64_t minusOne = mont.To(n - 1);
+        for (uint64_t a : {2ULL, 325ULL, 9375ULL, 28178ULL, 450775ULL, 9780504ULL, 1795265022ULL})
+        {
+            uint64_t x = mont.Power(mont.To(a), d);
+            if (x == 0 || x == one || x == minusOne) continue;
+
+            bool composite = true;
+            for (int i = 1; i < s; i++)
+            {
+                x = mont.Mul(x, x);
+                if (x == minusOne)
+                {
+                    composite = false;
+                    break;
+                }
+            }
+            if (composite) return false;
+        }
+        return true;
+    }
+
+    // prime factors of n >= 1 in increasing order, with multiplicity
+    static vector<ll> Factorize(ll n)
+    {
+        if (n <= 0) throw exception();
+
+        vector<ll> factors;
+        for (ll p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37})
+        {
+            while (n % p == 0)
+            {
+                factors.push_back(p);
+                n /= p;
+            }
+        }
+
+        FactorizeRec(n, factors);
+        sort(factors.begin(), factors.end());
+        return factors;
+    }
+
+    // (prime, exponent) pairs in increasing order of the prime
+    static vector<pair<ll, int>> PrimeFactorize(ll n)
+    {
+        vector<pair<ll, int>> result;
+        for (ll p : Factorize(n))
+        {
+            if (!result.empty() && result.back().first == p)
+            {
+                result.back().second++;
+            }
+            else
+            {
+                result.emplace_back(p, 1);
+            }
+        }
+        return result;
+    }
+
+private:
+    static void FactorizeRec(ll n, vector<ll>& factors)
+    {
+        if (n == 1) return;
+        if (IsPrime(n))
+        {
+            factors.push_back(n);
+            return;
+        }
+
+        ll d = PollardRho(n);
+        FactorizeRec(d, factors);
+        FactorizeRec(n / d, factors);
+    }
+
+    static uint64_t BinaryGcd(uint64_t a, uint64_t b)
+    {
+        if (a == 0) return b;
+        if (b == 0) return a;
+
+        int shift = __builtin_ctzll(a | b);
+        a >>= __builtin_ctzll(a);
+        while (b != 0)
+        {
+            b >>= __builtin_ctzll(b);
+            if (a > b) swap(a, b);
+            b -= a;
+        }
+        return a << shift;
+    }
+
+    // Brent's cycle detection on x^2 + c in Montgomery form; gcds are taken once per batch of differences
+    // and the last batch is replayed one step at a time when it overshoots to n.
+    // n must be an odd composite that is not a prime power of a small prime.
+    static ll PollardRho(ll n)
+    {
+        const int batch = 128;
+        Montgomery64 mont(n);
+
+        for (uint64_t c0 = 1;; c0++)
+        {
+            uint64_t c = mont.To(c0);
+            auto f = [&](uint64_t v)
+            {
+                return mont.Add(mont.Mul(v, v), c);
+            };
+
+            uint64_t x = 0, y = mont.To(2), ys = y, q = mont.To(1);
+            uint64_t g = 1;
+            for (int r = 1; g == 1; r <<= 1)
+            {
+                x = y;
+                for (int i = 0; i < r; i++)
+                {
+                    y = f(y);
+                }
+
+                for (int k = 0; k < r && g == 1; k += batch)
+                {
+                    ys = y;
+                    for (int i = 0; i < batch && i < r - k; i++)
+                    {
+                        y = f(y);
+                        q = mont.Mul(q, x > y ? x - y : y - x);
+                    }
+                    g = BinaryGcd(q, n);
+                }
+            }
+
+            if (g == (uint64_t)n)
+            {
+                do
+                {
+                    ys = f(ys);
+                    g = BinaryGcd(x > ys ? x - ys : ys - x, n);
+                } while (g == 1);
+            }
+
+            if (g != (uint64_t)n)
+            {
+                return (ll)g;
+            }
+        }
+    }
+};
+
+// Garner's algorithm: the value x in [0, m[0] * m[1] * ...) with x = r[i] (mod m[i]), reduced modulo target.
+// the moduli must be pairwise coprime. The per-moduli constants are computed once, so restoring each
+// coefficient of a convolution taken under several NTT primes costs O(k^2) multiplications and no inverse.
+class Garner
+{
+private:
+    int _count;
+    vector<ll> _mods;
+    // _prefix[i * (_count + 1) + j] = m[0] * ... * m[i - 1] mod _mods[j], where _mods[_count] is the target modulus
+    vector<ll> _prefix;
+    vector<ll> _inverse;
+    vector<ll> _work;
+    // every modulus is below 2^31, so products are reduced by Barrett with _barrett[j] = ceil(2^64 / _mods[j])
+    bool _narrow;
+    vector<unsigned long long> _barrett;
+
+public:
+    Garner(vector<ll>& mods, ll target)
+    {
+        _count = (int)mods.size();
+        _mods = mods;
+        _mods.push_back(target);
+        _narrow = all_of(_mods.begin(), _mods.end(), [](ll m) { return m < (1LL << 31); });
+        for (ll m : _mods)
+        {
+            _barrett.push_back((unsigned long long)-1 / m + 1);
+        }
+
+        int width = _count + 1;
+        _prefix.assign(width * width, 0);
+        for (int j = 0; j <= _count; j++)
+        {
+            _prefix[j] = 1 % _mods[j];
+        }
+        for (int i = 1; i <= _count; i++)
+        {
+            for (int j = 0; j <= _count; j++)
+            {
+                _prefix[i * width + j] = MulMod(_prefix[(i - 1) * width + j], mods[i - 1] % _mods[j], j);
+            }
+        }
+
+        _inverse.resize(_count);
+        for (int i = 0; i < _count; i++)
+        {
+            ll p, q;
+            Number::ExtEuclid(_prefix[i * width + i], _mods[i], p, q);
+            _inverse[i] = Number::SafeMod(p, _mods[i]);
+        }
+
+        _work.resize(_count + 1);
+    }
+
+    // residues[i] is the value modulo mods[i], in [0, mods[i])
+    ll Restore(const ll* residues)
+    {
+        // work[j] = the digits found so far, evaluated modulo _mods[j]
+        ll* work = _work.data();
+        const ll* mods = _mods.data();
+        fill(work, work + _count + 1, 0);
+        for (int i = 0; i < _count; i++)
+        {
+            const ll* prefix = _prefix.data() + i * (_count + 1);
+            ll diff = residues[i] - work[i];
+            ll t = MulMod(diff < 0 ? diff + mods[i] : diff, _inverse[i], i);
+            for (int j = i + 1; j <= _count; j++)
+            {
+                ll sum = work[j] + MulMod(t, prefix[j], j);
+                work[j] = sum >= mods[j] ? sum - mods[j] : sum;
+            }
+        }
+
+        return work[_count];
+    }
+
+    ll Restore(vector<ll>& residues)
+    {
+        return Restore(residues.data());
+    }
+
+    // out[k] restored from residues[i][k] for each i
+    void RestoreAll(vector<vector<ll>>& residues, vector<ll>& out)
+    {
+        int length = _count == 0 ? 0 : (int)residues[0].size();
+        out.resize(length);
+
+        vector<ll> column(_count);
+        for (int k = 0; k < length; k++)
+        {
+            for (int i = 0; i < _count; i++)
+            {
+                column[i] = residues[i][k];
+            }
+            out[k] = Restore(column.data());
+        }
+    }
+
+private:
+    // a * b mod _mods[j] for non-negative a, b; in the narrow case the Barrett quotient is off by at most one
+    // for any product below 2^64
+    inline ll MulMod(ll a, ll b, int j)
+    {
+        unsigned long long m = _mods[j];
+        if (_narrow)
+        {
+            unsigned long long z = (unsigned long long)a * (unsigned long long)b;
+            unsigned long long x = (unsigned long long)(((unsigned __int128)z * _barrett[j]) >> 64);
+            unsigned long long y = x * m;
+            return (ll)(z - y + (z < y ? m : 0));
+        }
+        return (ll)((__int128)a * b % (ll)m);
+    }
+};
@@ -0,0 +1,91 @@
+// PrefixSum and Imos gain their threaded overloads when this file is included before them.
+#define PARALLEL_SCAN
+
+// Inclusive prefix scan across the threads of a ThreadPool (thread_pool.cpp) in two passes over fixed-size blocks:
+// block totals, an exclusive scan of the totals, then each block is scanned from its offset.
+// Threads claim blocks from a shared counter, so the block size sets the scheduling granularity.
+// The threadCount overloads start a pool for the one call; pass a pool to reuse its threads across scans.
+class ParallelScan
+{
+public:
+    static constexpr size_t DefaultBlockSize = 1 << 16;
+
+    // out[i] = in[0] + ... + in[i]; in and out may be the same buffer
+    template <typename T>
+    static void Inclusive(const T* in, T* out, size_t n, ThreadPool& pool, size_t blockSize = DefaultBlockSize)
+    {
+        Inclusive(in, out, n, pool, blockSize, SequentialScan<T>);
+    }
+
+    template <typename T>
+    static void Inclusive(const T* in, T* out, size_t n, int threadCount, size_t blockSize = DefaultBlockSize)
+    {
+        Inclusive(in, out, n, threadCount, blockSize, SequentialScan<T>);
+    }
+
+    // scan(src, dst, length, carry) scans one block sequentially starting from carry
+    template <typename T, typename F>
+    static void Inclusive(const T* in, T* out, size_t n, int threadCount, size_t blockSize, F scan)
+    {
+        size_t blocks = (n + max(blockSize, (size_t)1) - 1) / max(blockSize, (size_t)1);
+        if (min((size_t)max(1, threadCount), blocks) <= 1)
+        {
+            scan(in, out, n, T(0));
+            return;
+        }
+
+        ThreadPool pool((int)min((size_t)threadCount, blocks));
+        Inclusive(in, out, n, pool, blockSize, scan);
+    }
+
+    template <typename T, typename F>
+    static void Inclusive(const T* in, T* out, size_t n, ThreadPool& pool, size_t blockSize, F scan)
+    {
+        blockSize = max(blockSize, (size_t)1);
+        size_t blocks = (n + blockSize - 1) / blockSize;
+        if (pool.ThreadCount() <= 1 || blocks <= 1)
+        {
+            scan(in, out, n, T(0));
+            return;
+        }
+
+        vector<T> offsets(blocks);
+        pool.ForEachBlock(blocks, [&](size_t b)
+        {
+            size_t begin = b * blockSize;
+            size_t end = min(n, begin + blockSize);
+            T sum = 0;
+            for (size_t i = begin; i < end; i++)
+            {
+                sum += in[i];
+            }
+            offsets[b] = sum;
+        });
+
+        T carry = 0;
+        for (size_t b = 0; b < blocks; b++)
+        {
+            T total = offsets[b];
+            offsets[b] = carry;
+            carry += total;
+        }
+
+        pool.ForEachBlock(blocks, [&](size_t b)
+        {
+            size_t begin = b * blockSize;
+            size_t end = min(n, begin + blockSize);
+            scan(in + begin, out + begin, end - begin, offsets[b]);
+        });
+    }
+
+private:
+    template <typename T>
+    static void SequentialScan(const T* src, T* dst, size_t length, T carry)
+    {
+        for (size_t i = 0; i < length; i++)
+        {
+            carry += src[i];
+            dst[i] = carry;
+        }
+    }
+};
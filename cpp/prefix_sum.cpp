@@ -1,3 +1,7 @@
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 template <typename T>
 class PrefixSum
 {
@@ -5,22 +9,60 @@ private:
     vector<T> _sums;
 
 public:
-    PrefixSum(vector<T>& sequence)
+    PrefixSum(vector<T>& sequence) : PrefixSum(span<const T>(sequence))
+    {
+    }
+
+    PrefixSum(span<const T> sequence)
     {
         _sums.resize(sequence.size() + 1);
 
         _sums[0] = 0;
-        for (int i = 0; i < (int)sequence.size(); i++)
-        {
-            _sums[i + 1] = _sums[i] + sequence[i];
-        }
+        Scan(sequence.data(), _sums.data() + 1, sequence.size(), T(0));
     }
 
+#ifdef PARALLEL_SCAN
+    // builds with ParallelScan (parallel_scan.cpp), each block through the same kernel as the sequential build
+    PrefixSum(span<const T> sequence, int threadCount, size_t blockSize = ParallelScan::DefaultBlockSize)
+    {
+        _sums.resize(sequence.size() + 1);
+
+        _sums[0] = 0;
+        ParallelScan::Inclusive(sequence.data(), _sums.data() + 1, sequence.size(), threadCount, blockSize, Scan);
+    }
+
+    PrefixSum(span<const T> sequence, ThreadPool& pool, size_t blockSize = ParallelScan::DefaultBlockSize)
+    {
+        _sums.resize(sequence.size() + 1);
+
+        _sums[0] = 0;
+        ParallelScan::Inclusive(sequence.data(), _sums.data() + 1, sequence.size(), pool, blockSize, Scan);
+    }
+#endif
+
     T Sum(int l, int r)
     {
         return _sums[r] - _sums[l];
     }
 
+    // out[i] = Sum(ls[i], rs[i]); the loads for later queries are prefetched while earlier ones resolve
+    void SumBatch(span<const int> ls, span<const int> rs, span<T> out)
+    {
+        const int distance = 16;
+        int count = (int)ls.size();
+        const T* sums = _sums.data();
+
+        for (int i = 0; i < count; i++)
+        {
+            if (i + distance < count)
+            {
+                __builtin_prefetch(sums + ls[i + distance]);
+                __builtin_prefetch(sums + rs[i + distance]);
+            }
+            out[i] = sums[rs[i]] - sums[ls[i]];
+        }
+    }
+
     T AllSum()
     {
         return _sums[_sums.size() - 1];
@@ -30,4 +72,69 @@ public:
     {
         return _sums;
     }
-};
\ No newline at end of file
+
+private:
+    // out[i] = carry + in[0] + ... + in[i]
+    static void Scan(const T* in, T* out, size_t n, T carry)
+    {
+        size_t i = 0;
+
+#if defined(__AVX2__)
+        if constexpr (is_same_v<T, int> || is_same_v<T, unsigned int>)
+        {
+            __m256i acc = _mm256_set1_epi32((int)carry);
+            for (; i + 8 <= n; i += 8)
+            {
+                __m256i x = _mm256_loadu_si256((const __m256i*)(in + i));
+                x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+                x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+                // carry the low 128-bit lane total into the high lane
+                __m256i low = _mm256_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+                x = _mm256_add_epi32(x, _mm256_permute2x128_si256(low, low, 0x08));
+                x = _mm256_add_epi32(x, acc);
+                _mm256_storeu_si256((__m256i*)(out + i), x);
+                acc = _mm256_permutevar8x32_epi32(x, _mm256_set1_epi32(7));
+            }
+            carry = (T)_mm256_extract_epi32(acc, 0);
+        }
+        else if constexpr (is_same_v<T, long long> || is_same_v<T, unsigned long long> || is_same_v<T, long> || is_same_v<T, unsigned long>)
+        {
+            static_assert(sizeof(T) == 8 || !(is_same_v<T, long> || is_same_v<T, unsigned long>));
+            __m256i acc = _mm256_set1_epi64x((long long)carry);
+            for (; i + 4 <= n; i += 4)
+            {
+                __m256i x = _mm256_loadu_si256((const __m256i*)(in + i));
+                x = _mm256_add_epi64(x, _mm256_slli_si256(x, 8));
+                __m256i low = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 1, 0, 0));
+                x = _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_setzero_si256(), low, 0xF0));
+                x = _mm256_add_epi64(x, acc);
+                _mm256_storeu_si256((__m256i*)(out + i), x);
+                acc = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 3, 3, 3));
+            }
+            carry = (T)_mm256_extract_epi64(acc, 0);
+        }
+        else if constexpr (is_same_v<T, double>)
+        {
+            // the in-register tree changes the summation order, so results may differ in the last bits
+            __m256d acc = _mm256_set1_pd(carry);
+            for (; i + 4 <= n; i += 4)
+            {
+                __m256d x = _mm256_loadu_pd(in + i);
+                x = _mm256_add_pd(x, _mm256_castsi256_pd(_mm256_slli_si256(_mm256_castpd_si256(x), 8)));
+                __m256d low = _mm256_permute4x64_pd(x, _MM_SHUFFLE(1, 1, 0, 0));
+                x = _mm256_add_pd(x, _mm256_blend_pd(_mm256_setzero_pd(), low, 0xC));
+                x = _mm256_add_pd(x, acc);
+                _mm256_storeu_pd(out + i, x);
+                acc = _mm256_permute4x64_pd(x, _MM_SHUFFLE(3, 3, 3, 3));
+            }
+            carry = _mm256_cvtsd_f64(acc);
+        }
+#endif
+
+        for (; i < n; i++)
+        {
+            carry += in[i];
+            out[i] = carry;
+        }
+    }
+};
@@ -2,32 +2,72 @@ template <typename T>
 class PrefixSum2D
 {
 private:
-    vector<vector<T>> _sums;
+    int _height;
+    int _width;
+    // (height + 1) x (width + 1), row-major with stride _width + 1
+    vector<T> _sums;
 
 public:
     PrefixSum2D(vector<vector<T>>& sequence)
     {
-        int height = sequence.size();
-        int width = sequence[0].size();
+        Init(sequence.size(), sequence[0].size());
 
-        _sums.resize(height + 1, vector<T>(width + 1, 0));
+        for (int y = 0; y < _height; y++)
+        {
+            BuildRow(y, sequence[y].data());
+        }
+    }
 
-        for (int y = 0; y < height; y++)
+    // data is row-major with stride width
+    PrefixSum2D(span<const T> data, int height, int width)
+    {
+        Init(height, width);
+
+        for (int y = 0; y < _height; y++)
         {
-            for (int x = 0; x < width; x++)
-            {
-                _sums[y + 1][x + 1] = _sums[y + 1][x] + _sums[y][x + 1] - _sums[y][x] + sequence[y][x];
-            }
+            BuildRow(y, data.data() + (size_t)y * width);
         }
     }
 
     T Sum(int startX, int startY, int endX, int endY)
     {
-        return _sums[endY][endX] + _sums[startY][startX] - _sums[startY][endX] - _sums[endY][startX];
+        return At(endX, endY) + At(startX, startY) - At(endX, startY) - At(startX, endY);
     }
 
     T AllSum()
     {
-        return _sums[(int)_sums.size() - 1][(int)_sums[0].size() - 1];
+        return At(_width, _height);
+    }
+
+private:
+    void Init(int height, int width)
+    {
+        _height = height;
+        _width = width;
+        _sums.assign((size_t)(_height + 1) * (_width + 1), 0);
+    }
+
+    inline T At(int x, int y)
+    {
+        return _sums[(size_t)y * (_width + 1) + x];
+    }
+
+    void BuildRow(int y, const T* row)
+    {
+        const T* above = _sums.data() + (size_t)y * (_width + 1);
+        T* current = _sums.data() + (size_t)(y + 1) * (_width + 1);
+
+        // running sum along the row, then one contiguous (vectorizable) add of the row above
+        T running = 0;
+        for (int x = 0; x < _width; x++)
+        {
+            running += row[x];
+            current[x + 1] = running;
+        }
+
+        for (int x = 1; x <= _width; x++)
+        {
+            current[x] += above[x];
+        }
     }
-};
\ No newline at end of file
+};
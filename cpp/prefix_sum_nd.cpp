@@ -0,0 +1,218 @@
+// D-dimensional prefix sum and imos over one row-major buffer; the last dimension is contiguous.
+// Coordinates are array<int, D> and ranges are half-open [lower, upper).
+class NDScan
+{
+public:
+    // in-place running sum along dimension d of a row-major buffer
+    template <typename T, size_t D>
+    static void Accumulate(T* data, const array<int, D>& shape, const array<size_t, D>& strides, int d)
+    {
+        size_t inner = strides[d];
+        size_t length = (size_t)shape[d];
+        size_t total = strides[0] * (size_t)shape[0];
+        if (total == 0)
+        {
+            return;
+        }
+
+        for (size_t outer = 0; outer < total; outer += inner * length)
+        {
+            for (size_t c = 1; c < length; c++)
+            {
+                T* current = data + outer + c * inner;
+                const T* previous = current - inner;
+                // contiguous block add: vectorizes for every dimension except the last
+                for (size_t k = 0; k < inner; k++)
+                {
+                    current[k] += previous[k];
+                }
+            }
+        }
+    }
+
+    template <size_t D>
+    static array<size_t, D> Strides(const array<int, D>& shape)
+    {
+        array<size_t, D> strides;
+        strides[D - 1] = 1;
+        for (int k = (int)D - 2; k >= 0; k--)
+        {
+            strides[k] = strides[k + 1] * (size_t)shape[k + 1];
+        }
+        return strides;
+    }
+};
+
+template <typename T, size_t D>
+class PrefixSumND
+{
+private:
+    array<int, D> _shape;
+    // the buffer has shape _shape[k] + 1 with a zero layer at coordinate 0 in each dimension
+    array<int, D> _paddedShape;
+    array<size_t, D> _strides;
+    vector<T> _sums;
+
+public:
+    // data is row-major with the given shape
+    PrefixSumND(const array<int, D>& shape, span<const T> data)
+    {
+        _shape = shape;
+        for (size_t k = 0; k < D; k++)
+        {
+            _paddedShape[k] = shape[k] + 1;
+        }
+        _strides = NDScan::Strides(_paddedShape);
+        _sums.assign(_strides[0] * (size_t)_paddedShape[0], 0);
+
+        int width = _shape[D - 1];
+        size_t rows = width == 0 ? 0 : data.size() / width;
+        array<int, D> index{};
+        for (size_t row = 0; row < rows; row++)
+        {
+            size_t offset = 1;
+            for (size_t k = 0; k + 1 < D; k++)
+            {
+                offset += (size_t)(index[k] + 1) * _strides[k];
+            }
+            copy(data.begin() + row * width, data.begin() + (row + 1) * width, _sums.begin() + offset);
+
+            for (int k = (int)D - 2; k >= 0; k--)
+            {
+                if (++index[k] < _shape[k]) break;
+                index[k] = 0;
+            }
+        }
+
+        for (size_t d = 0; d < D; d++)
+        {
+            NDScan::Accumulate(_sums.data(), _paddedShape, _strides, (int)d);
+        }
+    }
+
+    T Sum(const array<int, D>& lower, const array<int, D>& upper)
+    {
+        T res = 0;
+        [&]<size_t... M>(index_sequence<M...>)
+        {
+            (AddCorner<M>(res, lower, upper), ...);
+        }(make_index_sequence<(size_t)1 << D>());
+
+        return res;
+    }
+
+    T AllSum()
+    {
+        return _sums.back();
+    }
+
+    const array<int, D>& Shape()
+    {
+        return _shape;
+    }
+
+private:
+    // corner M takes lower[k] where bit k of M is set and upper[k] otherwise
+    template <size_t M>
+    inline void AddCorner(T& res, const array<int, D>& lower, const array<int, D>& upper)
+    {
+        size_t offset = CornerOffset<M>(lower, upper, make_index_sequence<D>());
+        if constexpr (popcount(M) % 2 == 0)
+        {
+            res += _sums[offset];
+        }
+        else
+        {
+            res -= _sums[offset];
+        }
+    }
+
+    template <size_t M, size_t... K>
+    inline size_t CornerOffset(const array<int, D>& lower, const array<int, D>& upper, index_sequence<K...>)
+    {
+        return (((size_t)(((M >> K) & 1) ? lower[K] : upper[K]) * _strides[K]) + ...);
+    }
+};
+
+template <typename T, size_t D>
+class ImosND
+{
+private:
+    array<int, D> _shape;
+    array<size_t, D> _strides;
+    vector<T> _data;
+
+public:
+    ImosND(const array<int, D>& shape)
+    {
+        _shape = shape;
+        _strides = NDScan::Strides(_shape);
+        _data.assign(_strides[0] * (size_t)_shape[0], 0);
+    }
+
+    void AddQuery(const array<int, D>& lower, const array<int, D>& upper, T value)
+    {
+        [&]<size_t... M>(index_sequence<M...>)
+        {
+            (AddCorner<M>(lower, upper, value), ...);
+        }(make_index_sequence<(size_t)1 << D>());
+    }
+
+    void Accumulate()
+    {
+        for (size_t d = 0; d < D; d++)
+        {
+            NDScan::Accumulate(_data.data(), _shape, _strides, (int)d);
+        }
+    }
+
+    T Get(const array<int, D>& index)
+    {
+        size_t offset = 0;
+        for (size_t k = 0; k < D; k++)
+        {
+            offset += (size_t)index[k] * _strides[k];
+        }
+        return _data[offset];
+    }
+
+    // row-major view with the last dimension contiguous
+    span<T> GetData()
+    {
+        return span<T>(_data);
+    }
+
+    const array<int, D>& Shape()
+    {
+        return _shape;
+    }
+
+private:
+    // corner M takes upper[k] where bit k of M is set; corners outside the grid are dropped
+    template <size_t M>
+    inline void AddCorner(const array<int, D>& lower, const array<int, D>& upper, T value)
+    {
+        size_t offset = 0;
+        bool inside = true;
+        for (size_t k = 0; k < D; k++)
+        {
+            int c = ((M >> k) & 1) ? upper[k] : lower[k];
+            inside &= c < _shape[k];
+            offset += (size_t)c * _strides[k];
+        }
+
+        if (!inside)
+        {
+            return;
+        }
+
+        if constexpr (popcount(M) % 2 == 0)
+        {
+            _data[offset] += value;
+        }
+        else
+        {
+            _data[offset] -= value;
+        }
+    }
+};
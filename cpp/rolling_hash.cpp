@@ -51,6 +51,102 @@ public:
     }
 };
 
+// base^i under MUL, grown on demand with doubling. Entries live in segments of size 2^k that never move,
+// so indices below the published size are read without taking the lock.
+template <ll MUL(ll, ll)>
+class PowerTable
+{
+private:
+    static const int SegmentCount = 48;
+
+    ll _base;
+    atomic<ll*> _segments[SegmentCount];
+    atomic<ll> _size;
+    mutex _mutex;
+
+public:
+    PowerTable(ll base)
+    {
+        _base = base;
+        _size.store(0);
+        for (int i = 0; i < SegmentCount; i++)
+        {
+            _segments[i].store(nullptr);
+        }
+    }
+
+    PowerTable(const PowerTable&) = delete;
+    PowerTable& operator=(const PowerTable&) = delete;
+
+    ~PowerTable()
+    {
+        for (int i = 0; i < SegmentCount; i++)
+        {
+            delete[] _segments[i].load();
+        }
+    }
+
+    inline ll operator[](ll exp)
+    {
+        if (exp >= _size.load(memory_order_acquire))
+        {
+            Grow(exp + 1);
+        }
+
+        return At(exp);
+    }
+
+    void Reserve(ll size)
+    {
+        if (size > _size.load(memory_order_acquire))
+        {
+            Grow(size);
+        }
+    }
+
+    ll Size()
+    {
+        return _size.load(memory_order_acquire);
+    }
+
+private:
+    inline ll& At(ll exp)
+    {
+        unsigned long long i = (unsigned long long)exp + 1;
+        int segment = 63 - __builtin_clzll(i);
+        return _segments[segment].load(memory_order_relaxed)[i - (1ULL << segment)];
+    }
+
+    void Grow(ll size)
+    {
+        lock_guard<mutex> lock(_mutex);
+
+        ll current = _size.load(memory_order_relaxed);
+        if (size <= current)
+        {
+            return;
+        }
+
+        size = max(size, current * 2);
+
+        for (int k = 0; k < SegmentCount && (1LL << k) - 1 < size; k++)
+        {
+            if (_segments[k].load(memory_order_relaxed) == nullptr)
+            {
+                _segments[k].store(new ll[1LL << k], memory_order_relaxed);
+            }
+        }
+
+        for (ll i = current; i < size; i++)
+        {
+            At(i) = i == 0 ? 1LL : MUL(At(i - 1), _base);
+        }
+
+        // publishes the filled entries together with the segment pointers
+        _size.store(size, memory_order_release);
+    }
+};
+
 class RabinKarp
 {
 public:
@@ -59,9 +155,19 @@ public:
     static const ll BaseB = 8761;
     static const ll ModB = 999750347;
 
+    static inline ll MulA(ll a, ll b)
+    {
+        return (a * b) % ModA;
+    }
+
+    static inline ll MulB(ll a, ll b)
+    {
+        return (a * b) % ModB;
+    }
+
 private:
-    static vector<ll> _powerA;
-    static vector<ll> _powerB;
+    static PowerTable<MulA> _powerA;
+    static PowerTable<MulB> _powerB;
 
 public:
     static inline ll SafeMod(ll a, ll m)
@@ -69,17 +175,11 @@ public:
         return ((a % m) + m) % m;
     }
 
+    // optional: the power tables grow on demand, this only pre-fills them
     static void Setup(int maxLength)
     {
-        _powerA.resize(maxLength + 1);
-        _powerB.resize(maxLength + 1);
-        _powerA[0] = 1LL;
-        _powerB[0] = 1LL;
-        for (int i = 1; i <= maxLength; i++)
-        {
-            _powerA[i] = (_powerA[i - 1] * BaseA) % ModA;
-            _powerB[i] = (_powerB[i - 1] * BaseB) % ModB;
-        }
+        _powerA.Reserve(maxLength + 1);
+        _powerB.Reserve(maxLength + 1);
     }
 
     static RollingHash PrefixDiff(RollingHash left, RollingHash right)
@@ -128,8 +228,89 @@ public:
     }
 };
 
-vector<ll> RabinKarp::_powerA;
-vector<ll> RabinKarp::_powerB;
+PowerTable<RabinKarp::MulA> RabinKarp::_powerA(RabinKarp::BaseA);
+PowerTable<RabinKarp::MulB> RabinKarp::_powerB(RabinKarp::BaseB);
+
+// LCP of two suffixes by binary search over a hash equality test equal(i, j, len).
+// FindBatch runs BatchWidth searches in lockstep so that their prefix loads are independent and overlap.
+class HashLCP
+{
+public:
+    static constexpr int BatchWidth = 32;
+
+    // I is the index type: int for strings, ll for views of large files
+    template <typename I, typename E>
+    static I Find(I length, I i, I j, E equal)
+    {
+        I lo = 0;
+        I hi = length - max(i, j);
+        while (lo < hi)
+        {
+            I mid = (lo + hi + 1) >> 1;
+            if (equal(i, j, mid))
+            {
+                lo = mid;
+            }
+            else
+            {
+                hi = mid - 1;
+            }
+        }
+
+        return lo;
+    }
+
+    // prefix is the prefix-hash array that equal reads, used only for prefetching
+    template <typename I, typename P, typename E>
+    static void FindBatch(I length, const vector<pair<I, I>>& queries, vector<I>& result, const P* prefix, E equal)
+    {
+        result.resize(queries.size());
+
+        I lo[BatchWidth];
+        I hi[BatchWidth];
+
+        for (int s = 0; s < (int)queries.size(); s += BatchWidth)
+        {
+            int count = min(BatchWidth, (int)queries.size() - s);
+            for (int k = 0; k < count; k++)
+            {
+                lo[k] = 0;
+                hi[k] = length - max(queries[s + k].first, queries[s + k].second);
+            }
+
+            bool active = true;
+            while (active)
+            {
+                active = false;
+                for (int k = 0; k < count; k++)
+                {
+                    I mid = (lo[k] + hi[k] + 1) >> 1;
+                    __builtin_prefetch(prefix + queries[s + k].first + mid);
+                    __builtin_prefetch(prefix + queries[s + k].second + mid);
+                }
+
+                for (int k = 0; k < count; k++)
+                {
+                    if (lo[k] >= hi[k])
+                    {
+                        continue;
+                    }
+
+                    active = true;
+                    I mid = (lo[k] + hi[k] + 1) >> 1;
+                    bool same = equal(queries[s + k].first, queries[s + k].second, mid);
+                    lo[k] = same ? mid : lo[k];
+                    hi[k] = same ? hi[k] : mid - 1;
+                }
+            }
+
+            for (int k = 0; k < count; k++)
+            {
+                result[s + k] = lo[k];
+            }
+        }
+    }
+};
 
 class RollingHashString
 {
@@ -142,8 +323,8 @@ public:
     RollingHashString(string source)
     {
         assert(source.size() != 0);
-        _source = source;
-        _length = (int)source.size();
+        _source = move(source);
+        _length = (int)_source.size();
         // pre-compute prefix hashes
 
         _prefix.resize(_length + 1);
@@ -166,7 +347,39 @@ public:
         return _prefix[length];
     }
 
-    string Source()
+    bool Equal(int l1, int r1, int l2, int r2)
+    {
+        assert(0 <= l1 && l1 <= r1 && r1 <= _length && 0 <= l2 && l2 <= r2 && r2 <= _length);
+        if (r1 - l1 != r2 - l2)
+        {
+            return false;
+        }
+
+        int len = r1 - l1;
+
+        // p[r1] - p[l1] * B^len - (p[r2] - p[l2] * B^len) stays far below 2^63, so one % per modulus is enough
+        ll da = _prefix[r1].HashA() - _prefix[r2].HashA() + (_prefix[l2].HashA() - _prefix[l1].HashA()) * RabinKarp::PowerA(len);
+        if (da % RabinKarp::ModA != 0)
+        {
+            return false;
+        }
+
+        ll db = _prefix[r1].HashB() - _prefix[r2].HashB() + (_prefix[l2].HashB() - _prefix[l1].HashB()) * RabinKarp::PowerB(len);
+        return db % RabinKarp::ModB == 0;
+    }
+
+    // length of the longest common prefix of the suffixes starting at i and j
+    int LCP(int i, int j)
+    {
+        return HashLCP::Find(_length, i, j, [&](int a, int b, int len) { return Equal(a, a + len, b, b + len); });
+    }
+
+    void LCPBatch(const vector<pair<int, int>>& queries, vector<int>& result)
+    {
+        HashLCP::FindBatch(_length, queries, result, _prefix.data(), [&](int a, int b, int len) { return Equal(a, a + len, b, b + len); });
+    }
+
+    const string& Source()
     {
         return _source;
     }
@@ -175,4 +388,253 @@ public:
     {
         return _length;
     }
-};
\ No newline at end of file
+};
+
+// Single-modulus rolling hash over 2^61 - 1 with a random base; reductions use shifts instead of division.
+class RabinKarp61
+{
+public:
+    static const ll Mod = (1LL << 61) - 1;
+    static const ll Base;
+
+    static inline ll Reduce(unsigned __int128 x)
+    {
+        // valid for x < 7 * 2^122, where the first fold cannot overflow 64 bits; two folds bring the value below 2 * Mod.
+        // BuildPrefix, the largest caller, stays below 4 * 2^122.
+        unsigned long long r = (unsigned long long)(x >> 61) + (unsigned long long)(x & Mod);
+        r = (r & Mod) + (r >> 61);
+        return (ll)(r >= (unsigned long long)Mod ? r - Mod : r);
+    }
+
+    static inline ll Mul(ll a, ll b)
+    {
+        return Reduce((unsigned __int128)a * b);
+    }
+
+private:
+    static PowerTable<Mul> _power;
+
+public:
+    static inline ll Add(ll a, ll b)
+    {
+        ll r = a + b;
+        return r >= Mod ? r - Mod : r;
+    }
+
+    static inline ll Sub(ll a, ll b)
+    {
+        ll r = a - b;
+        return r < 0 ? r + Mod : r;
+    }
+
+    // optional: the power table grows on demand, this only pre-fills it
+    static void Setup(ll maxLength)
+    {
+        _power.Reserve(maxLength + 1);
+    }
+
+    inline static ll Power(ll exp)
+    {
+        return _power[exp];
+    }
+
+    static ll PrefixDiff(ll left, ll right, ll diff)
+    {
+        return Sub(right, Mul(left, _power[diff]));
+    }
+
+    static ll Concat(ll left, ll right, ll rightLength)
+    {
+        return Add(Mul(left, _power[rightLength]), right);
+    }
+
+    static ll HashFromString(const string& s)
+    {
+        ll hash = 0LL;
+        for (int i = 0; i < (int)s.size(); i++)
+        {
+            hash = Reduce((unsigned __int128)hash * Base + (unsigned char)s[i]);
+        }
+
+        return hash;
+    }
+
+    // prefix[i] = hash of s[0, i). Four characters are folded per step so that only one
+    // multiplication per block sits on the dependency chain and the rest can overlap.
+    static void BuildPrefix(const char* s, ll length, ll* prefix)
+    {
+        typedef unsigned __int128 u128;
+
+        ll b1 = Base;
+        ll b2 = Mul(b1, Base);
+        ll b3 = Mul(b2, Base);
+        ll b4 = Mul(b3, Base);
+
+        prefix[0] = 0LL;
+        ll i = 0;
+        for (; i + 4 <= length; i += 4)
+        {
+            u128 h = (u128)prefix[i];
+            ll c1 = (unsigned char)s[i];
+            ll c2 = (unsigned char)s[i + 1];
+            ll c3 = (unsigned char)s[i + 2];
+            ll c4 = (unsigned char)s[i + 3];
+
+            prefix[i + 1] = Reduce(h * b1 + c1);
+            prefix[i + 2] = Reduce(h * b2 + (u128)c1 * b1 + c2);
+            prefix[i + 3] = Reduce(h * b3 + (u128)c1 * b2 + (u128)c2 * b1 + c3);
+            prefix[i + 4] = Reduce(h * b4 + (u128)c1 * b3 + (u128)c2 * b2 + (u128)c3 * b1 + c4);
+        }
+
+        for (; i < length; i++)
+        {
+            prefix[i + 1] = Reduce((u128)prefix[i] * b1 + (unsigned char)s[i]);
+        }
+    }
+
+private:
+    static ll RandomBase()
+    {
+        random_device seed;
+        mt19937_64 rng(seed() ^ (unsigned long long)chrono::steady_clock::now().time_since_epoch().count());
+        return (ll)(rng() % (Mod - (1LL << 21))) + (1LL << 20);
+    }
+};
+
+const ll RabinKarp61::Base = RabinKarp61::RandomBase();
+PowerTable<RabinKarp61::Mul> RabinKarp61::_power(RabinKarp61::Base);
+
+class RollingHashString61
+{
+private:
+    int _length;
+    string _source;
+    vector<ll> _prefix;
+
+public:
+    RollingHashString61(string source)
+    {
+        assert(source.size() != 0);
+        _source = move(source);
+        _length = (int)_source.size();
+
+        _prefix.resize(_length + 1);
+        RabinKarp61::BuildPrefix(_source.data(), _length, _prefix.data());
+    }
+
+    ll GetHash(int l, int r)
+    {
+        assert(0 <= l && l < _length && l <= r && r <= _length);
+        return RabinKarp61::PrefixDiff(_prefix[l], _prefix[r], r - l);
+    }
+
+    ll GetPrefixHash(int length)
+    {
+        assert(0 <= length && length <= _length);
+        return _prefix[length];
+    }
+
+    bool Equal(int l1, int r1, int l2, int r2)
+    {
+        assert(0 <= l1 && l1 <= r1 && r1 <= _length && 0 <= l2 && l2 <= r2 && r2 <= _length);
+        if (r1 - l1 != r2 - l2)
+        {
+            return false;
+        }
+
+        ll p = RabinKarp61::Power(r1 - l1);
+        return RabinKarp61::Sub(_prefix[r1], RabinKarp61::Mul(_prefix[l1], p)) == RabinKarp61::Sub(_prefix[r2], RabinKarp61::Mul(_prefix[l2], p));
+    }
+
+    // length of the longest common prefix of the suffixes starting at i and j
+    int LCP(int i, int j)
+    {
+        return HashLCP::Find(_length, i, j, [&](int a, int b, int len) { return Equal(a, a + len, b, b + len); });
+    }
+
+    void LCPBatch(const vector<pair<int, int>>& queries, vector<int>& result)
+    {
+        HashLCP::FindBatch(_length, queries, result, _prefix.data(), [&](int a, int b, int len) { return Equal(a, a + len, b, b + len); });
+    }
+
+    const string& Source()
+    {
+        return _source;
+    }
+
+    int Length()
+    {
+        return _length;
+    }
+};
+
+// Hashes a string_view (e.g. MappedFile::View()) without copying it; the viewed memory must outlive this object.
+class RollingHashStringView
+{
+private:
+    string_view _source;
+    vector<ll> _prefix;
+
+public:
+    RollingHashStringView(string_view source)
+    {
+        _source = source;
+        _prefix.resize(_source.size() + 1);
+        RabinKarp61::BuildPrefix(_source.data(), (ll)_source.size(), _prefix.data());
+    }
+
+    ll GetHash(ll l, ll r)
+    {
+        assert(0 <= l && l <= r && r <= Length());
+        return RabinKarp61::PrefixDiff(_prefix[l], _prefix[r], r - l);
+    }
+
+    ll GetPrefixHash(ll length)
+    {
+        assert(0 <= length && length <= Length());
+        return _prefix[length];
+    }
+
+    bool Equal(ll l1, ll r1, ll l2, ll r2)
+    {
+        assert(0 <= l1 && l1 <= r1 && r1 <= Length() && 0 <= l2 && l2 <= r2 && r2 <= Length());
+        if (r1 - l1 != r2 - l2)
+        {
+            return false;
+        }
+
+        ll p = RabinKarp61::Power(r1 - l1);
+        return RabinKarp61::Sub(_prefix[r1], RabinKarp61::Mul(_prefix[l1], p)) == RabinKarp61::Sub(_prefix[r2], RabinKarp61::Mul(_prefix[l2], p));
+    }
+
+    // length of the longest common prefix of the suffixes starting at i and j
+    ll LCP(ll i, ll j)
+    {
+        return HashLCP::Find(Length(), i, j, [&](ll a, ll b, ll len) { return Equal(a, a + len, b, b + len); });
+    }
+
+    void LCPBatch(const vector<pair<ll, ll>>& queries, vector<ll>& result)
+    {
+        HashLCP::FindBatch(Length(), queries, result, _prefix.data(), [&](ll a, ll b, ll len) { return Equal(a, a + len, b, b + len); });
+    }
+
+    string_view Substring(ll l, ll r)
+    {
+        return _source.substr(l, r - l);
+    }
+
+    string_view Source()
+    {
+        return _source;
+    }
+
+    const vector<ll>& Prefix()
+    {
+        return _prefix;
+    }
+
+    ll Length()
+    {
+        return (ll)_source.size();
+    }
+};
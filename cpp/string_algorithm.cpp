@@ -0,0 +1,93 @@
+class StringAlgorithm
+{
+public:
+    // z[i] = LCP of s and s[i..]
+    static vector<int> CalcZArray(string_view s)
+    {
+        int length = (int)s.size();
+        vector<int> z(length);
+        if (length == 0)
+        {
+            return z;
+        }
+
+        z[0] = length;
+        int l = 0;
+        int r = 0;
+        for (int i = 1; i < length; i++)
+        {
+            if (z[i - l] < r - i)
+            {
+                z[i] = z[i - l];
+            }
+            else
+            {
+                r = max(r, i);
+                while (r < length && s[r] == s[r - i])
+                {
+                    r++;
+                }
+                z[i] = r - i;
+                l = i;
+            }
+        }
+
+        return z;
+    }
+
+    // pi[i] = length of the longest proper border of s[0..i]
+    static vector<int> CalcPrefixFunction(string_view s)
+    {
+        int length = (int)s.size();
+        vector<int> pi(length);
+        for (int i = 1; i < length; i++)
+        {
+            int k = pi[i - 1];
+            while (k > 0 && s[i] != s[k])
+            {
+                k = pi[k - 1];
+            }
+
+            if (s[i] == s[k])
+            {
+                k++;
+            }
+            pi[i] = k;
+        }
+
+        return pi;
+    }
+
+    // calls f(start) for every occurrence of pattern in text
+    template <typename F>
+    static void KMPSearch(string_view text, string_view pattern, F f)
+    {
+        int m = (int)pattern.size();
+        if (m == 0)
+        {
+            return;
+        }
+
+        vector<int> pi = CalcPrefixFunction(pattern);
+
+        int k = 0;
+        for (int i = 0; i < (int)text.size(); i++)
+        {
+            while (k > 0 && text[i] != pattern[k])
+            {
+                k = pi[k - 1];
+            }
+
+            if (text[i] == pattern[k])
+            {
+                k++;
+            }
+
+            if (k == m)
+            {
+                f(i - m + 1);
+                k = pi[k - 1];
+            }
+        }
+    }
+};
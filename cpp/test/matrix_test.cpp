@@ -0,0 +1,107 @@
+// g++ -std=c++20 -O2 matrix_test.cpp && ./a.out
+#include <bits/stdc++.h>
+using namespace std;
+typedef long long ll;
+
+#include "../modint.cpp"
+#include "../matrix.cpp"
+
+// reference product with every entry reduced through ModInt arithmetic
+Matrix<ModInt> Naive(Matrix<ModInt>& left, Matrix<ModInt>& right)
+{
+    Matrix<ModInt> dest(left.Rows(), right.Cols());
+    for (int i = 0; i < left.Rows(); i++)
+    {
+        for (int j = 0; j < right.Cols(); j++)
+        {
+            ModInt sum = 0L;
+            for (int k = 0; k < left.Cols(); k++)
+            {
+                sum += (left(i, k) + 0L) * (right(k, j) + 0L);
+            }
+            dest(i, j) = sum;
+        }
+    }
+    return dest;
+}
+
+int main()
+{
+    // all -1 except a +1 column: each product entry sums to 0
+    Matrix<ModInt> a(3, 3), b(3, 3);
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            a(i, j) = ModInt(-1L);
+            b(i, j) = ModInt(i == 0 ? 2L : -1L);
+        }
+    }
+    Matrix<ModInt> c = a * b;
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            assert(c(i, j).Value == 0);
+        }
+    }
+
+    // unreduced entries: negative, CONST_MOD and beyond, on shapes that are not multiples of the tiles
+    mt19937_64 rng(48);
+    for (int it = 0; it < 20; it++)
+    {
+        int n = (int)(rng() % 13) + 1, m = (int)(rng() % 21) + 1, p = (int)(rng() % 19) + 1;
+        Matrix<ModInt> left(n, m), right(m, p);
+        for (ModInt& x : left.GetData())
+        {
+            x = ModInt((ll)(rng() % (8 * CONST_MOD)) - 4 * CONST_MOD);
+        }
+        for (ModInt& x : right.GetData())
+        {
+            x = ModInt((ll)(rng() % (8 * CONST_MOD)) - 4 * CONST_MOD);
+        }
+
+        Matrix<ModInt> fast = left * right;
+        Matrix<ModInt> slow = Naive(left, right);
+        for (int i = 0; i < n; i++)
+        {
+            for (int j = 0; j < p; j++)
+            {
+                assert(fast(i, j).Value == slow(i, j).Value);
+            }
+        }
+    }
+
+    // one scratch reused across shapes that grow and shrink, and Power against repeated multiplies
+    Matrix<ModInt>::MultiplyScratch scratch;
+    for (int it = 0; it < 20; it++)
+    {
+        int n = (int)(rng() % 17) + 1;
+        Matrix<ModInt> base(n);
+        for (ModInt& x : base.GetData())
+        {
+            x = ModInt((ll)(rng() % (8 * CONST_MOD)) - 4 * CONST_MOD);
+        }
+
+        Matrix<ModInt> square;
+        Matrix<ModInt>::Multiply(base, base, square, scratch);
+        Matrix<ModInt> slow = Naive(base, base);
+        Matrix<ModInt> power = base.Power(it % 7);
+        Matrix<ModInt> repeated = Matrix<ModInt>::Identity(n);
+        for (int e = 0; e < it % 7; e++)
+        {
+            repeated = Naive(repeated, base);
+        }
+        for (int i = 0; i < n; i++)
+        {
+            for (int j = 0; j < n; j++)
+            {
+                assert(square(i, j).Value == slow(i, j).Value);
+                assert(power(i, j).Value == repeated(i, j).Value);
+            }
+        }
+    }
+
+    puts("ok");
+    return 0;
+}
@@ -0,0 +1,47 @@
+// g++ -std=c++20 -O2 number_test.cpp && ./a.out
+#include <bits/stdc++.h>
+using namespace std;
+typedef long long ll;
+
+#include "../number.cpp"
+
+bool Throws(ll n)
+{
+    try
+    {
+        Number::Factorize(n);
+    }
+    catch (exception&)
+    {
+        return true;
+    }
+    return false;
+}
+
+int main()
+{
+    assert(Throws(0));
+    assert(Throws(-1));
+    assert(Throws(-12));
+    assert(Throws(LLONG_MIN));
+
+    assert(Number::Factorize(1).empty());
+    assert((Number::Factorize(360) == vector<ll>{2, 2, 2, 3, 3, 5}));
+    assert((Number::Factorize(1000000007LL * 998244353LL) == vector<ll>{998244353, 1000000007}));
+
+    mt19937_64 rng(46);
+    for (int it = 0; it < 1000; it++)
+    {
+        ll n = (ll)(rng() % 1000000000000LL) + 1;
+        ll product = 1;
+        for (ll p : Number::Factorize(n))
+        {
+            assert(Number::IsPrime(p));
+            product *= p;
+        }
+        assert(product == n);
+    }
+
+    puts("ok");
+    return 0;
+}
@@ -0,0 +1,53 @@
+// g++ -std=c++20 -O2 -march=native parallel_scan_bench.cpp && ./a.out [n = 100000000] [max threads = hardware]
+// In-place inclusive scan of n 32-bit values: a sequential loop against ParallelScan on one reused ThreadPool
+// per thread count, best of 3 runs each. The request's 10^9 elements need 4 GB.
+#include <bits/stdc++.h>
+using namespace std;
+typedef long long ll;
+
+#include "../thread_pool.cpp"
+#include "../parallel_scan.cpp"
+
+template <typename F>
+double BestOf3(vector<uint32_t>& data, F f)
+{
+    double best = 1e18;
+    for (int run = 0; run < 3; run++)
+    {
+        fill(data.begin(), data.end(), 1u);
+        auto start = chrono::steady_clock::now();
+        f();
+        best = min(best, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+        assert(data.back() == (uint32_t)data.size());
+    }
+    return best;
+}
+
+int main(int argc, char** argv)
+{
+    size_t n = argc > 1 ? (size_t)atoll(argv[1]) : 100000000;
+    int maxThreads = argc > 2 ? atoi(argv[2]) : (int)max(1u, thread::hardware_concurrency());
+    vector<uint32_t> data(n);
+
+    double sequential = BestOf3(data, [&]()
+    {
+        for (size_t i = 1; i < n; i++)
+        {
+            data[i] += data[i - 1];
+        }
+    });
+    printf("n = %zu, hardware threads = %u\n", n, thread::hardware_concurrency());
+    printf("sequential        %9.1f ms\n", sequential);
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        ThreadPool pool(threads);
+        double time = BestOf3(data, [&]()
+        {
+            ParallelScan::Inclusive(data.data(), data.data(), n, pool);
+        });
+        printf("%2d threads        %9.1f ms  %.2fx\n", threads, time, sequential / time);
+    }
+
+    return 0;
+}
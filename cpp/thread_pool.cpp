@@ -0,0 +1,143 @@
+// Fixed set of worker threads that are started once and woken for each parallel step, so repeated steps
+// (scan passes, graph layers, Boruvka rounds) do not pay for thread creation. The calling thread works as thread 0.
+// Only one step may run at a time.
+class ThreadPool
+{
+private:
+    vector<thread> _workers;
+    mutex _mutex;
+    condition_variable _start;
+    condition_variable _finish;
+    function<void(int)> _task;
+    ll _generation;
+    int _running;
+    bool _stop;
+
+public:
+    ThreadPool(int threadCount)
+    {
+        _generation = 0;
+        _running = 0;
+        _stop = false;
+
+        for (int t = 1; t < max(1, threadCount); t++)
+        {
+            _workers.emplace_back([this, t]()
+            {
+                Work(t);
+            });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            lock_guard<mutex> lock(_mutex);
+            _stop = true;
+        }
+        _start.notify_all();
+
+        for (thread& worker : _workers)
+        {
+            worker.join();
+        }
+    }
+
+    int ThreadCount()
+    {
+        return (int)_workers.size() + 1;
+    }
+
+    // f(t) once on every thread t in [0, ThreadCount()); returns when all of them have finished
+    template <typename F>
+    void RunAll(F f)
+    {
+        if (_workers.empty())
+        {
+            f(0);
+            return;
+        }
+
+        {
+            lock_guard<mutex> lock(_mutex);
+            _task = [&f](int t)
+            {
+                f(t);
+            };
+            _running = (int)_workers.size();
+            _generation++;
+        }
+        _start.notify_all();
+
+        f(0);
+
+        unique_lock<mutex> lock(_mutex);
+        _finish.wait(lock, [&]()
+        {
+            return _running == 0;
+        });
+        _task = nullptr;
+    }
+
+    // f(t, begin, end) for chunk t of min(ThreadCount(), n) contiguous chunks of [0, n)
+    template <typename F>
+    void For(int n, F f)
+    {
+        int count = max(1, min(ThreadCount(), n));
+        int chunk = (n + count - 1) / count;
+        RunAll([&](int t)
+        {
+            if (t < count)
+            {
+                f(t, min(n, t * chunk), min(n, (t + 1) * chunk));
+            }
+        });
+    }
+
+    // f(b) for every b in [0, blocks); threads claim blocks from a shared counter
+    template <typename F>
+    void ForEachBlock(size_t blocks, F f)
+    {
+        atomic<size_t> next(0);
+        RunAll([&](int)
+        {
+            for (size_t b = next.fetch_add(1, memory_order_relaxed); b < blocks; b = next.fetch_add(1, memory_order_relaxed))
+            {
+                f(b);
+            }
+        });
+    }
+
+private:
+    void Work(int t)
+    {
+        ll seen = 0;
+        while (true)
+        {
+            {
+                unique_lock<mutex> lock(_mutex);
+                _start.wait(lock, [&]()
+                {
+                    return _stop || _generation != seen;
+                });
+                if (_stop)
+                {
+                    return;
+                }
+                seen = _generation;
+            }
+
+            // _task is only replaced after every worker has reported back
+            _task(t);
+
+            lock_guard<mutex> lock(_mutex);
+            if (--_running == 0)
+            {
+                _finish.notify_one();
+            }
+        }
+    }
+};
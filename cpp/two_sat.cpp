@@ -0,0 +1,50 @@
+class TwoSat
+{
+private:
+    int _n;
+    DirectedGraph<int> _graph;
+    vector<bool> _answer;
+
+public:
+    TwoSat(int n) : _graph(2 * n)
+    {
+        _n = n;
+        _answer.resize(n);
+    }
+
+    int Count()
+    {
+        return _n;
+    }
+
+    // adds the clause (x_i == f) || (x_j == g)
+    void AddClause(int i, bool f, int j, bool g)
+    {
+        _graph.AddEdge(2 * i + (f ? 0 : 1), 2 * j + (g ? 1 : 0), 0);
+        _graph.AddEdge(2 * j + (g ? 0 : 1), 2 * i + (f ? 1 : 0), 0);
+    }
+
+    bool Satisfiable()
+    {
+        vector<int> ids;
+        _graph.SplitSCC(ids);
+
+        for (int i = 0; i < _n; i++)
+        {
+            if (ids[2 * i] == ids[2 * i + 1])
+            {
+                return false;
+            }
+
+            // vertex 2i + 1 means x_i is true; pick the literal that comes later in topological order
+            _answer[i] = ids[2 * i] < ids[2 * i + 1];
+        }
+
+        return true;
+    }
+
+    vector<bool>& Answer()
+    {
+        return _answer;
+    }
+};
@@ -0,0 +1,404 @@
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// Wavelet matrix over 64-bit keys. Positions are 0-indexed and ranges are half-open [l, r), as in wavelet_matrix.cs.
+class WaveletMatrix
+{
+private:
+    // One level of the matrix. Each 64-byte line holds the number of ones before it followed by 448 bits,
+    // so a rank touches a single cache line.
+    class Level
+    {
+    private:
+        static constexpr int LineBits = 448;
+
+        struct alignas(64) Line
+        {
+            uint64_t Rank;
+            uint64_t Words[7];
+        };
+
+        vector<Line> _lines;
+        int _length;
+        int _ones;
+
+    public:
+        // words holds the bits in order; line i takes words 7i to 7i + 6
+        Level(const vector<uint64_t>& words, int length)
+        {
+            _length = length;
+            _lines.assign(length / LineBits + 1, Line{});
+
+            uint64_t rank = 0;
+            for (size_t i = 0; i < _lines.size(); i++)
+            {
+                Line& line = _lines[i];
+                line.Rank = rank;
+                for (size_t w = 0; w < 7 && 7 * i + w < words.size(); w++)
+                {
+                    line.Words[w] = words[7 * i + w];
+                    rank += popcount(line.Words[w]);
+                }
+            }
+            _ones = (int)rank;
+        }
+
+        inline int Get(int i) const
+        {
+            return (int)((_lines[i / LineBits].Words[i % LineBits / 64] >> (i % 64)) & 1);
+        }
+
+        // ones in [0, i)
+        inline int Rank1(int i) const
+        {
+            const Line& line = _lines[i / LineBits];
+            int offset = i % LineBits;
+            int full = offset / 64;
+
+            uint64_t rank = line.Rank;
+            for (int w = 0; w < 7; w++)
+            {
+                uint64_t mask = w < full ? ~0ULL : (w == full ? (1ULL << (offset % 64)) - 1 : 0);
+                rank += popcount(line.Words[w] & mask);
+            }
+            return (int)rank;
+        }
+
+        inline int Rank0(int i) const
+        {
+            return i - Rank1(i);
+        }
+
+        int Ones() const
+        {
+            return _ones;
+        }
+
+        // position of the k-th (0-indexed) one or zero
+        int Select(int bit, int k) const
+        {
+            auto count = [&](int line)
+            {
+                return bit == 1 ? (int)_lines[line].Rank : line * LineBits - (int)_lines[line].Rank;
+            };
+
+            int lo = 0, hi = (int)_lines.size();
+            while (hi - lo > 1)
+            {
+                int mid = (lo + hi) / 2;
+                if (count(mid) <= k) lo = mid;
+                else hi = mid;
+            }
+
+            k -= count(lo);
+            const Line& line = _lines[lo];
+            for (int w = 0; w < 7; w++)
+            {
+                uint64_t word = bit == 1 ? line.Words[w] : ~line.Words[w];
+                int c = popcount(word);
+                if (k < c)
+                {
+                    return lo * LineBits + w * 64 + SelectInWord(word, k);
+                }
+                k -= c;
+            }
+            return -1;
+        }
+
+    private:
+        static inline int SelectInWord(uint64_t word, int k)
+        {
+#if defined(__BMI2__)
+            return __builtin_ctzll(_pdep_u64(1ULL << k, word));
+#else
+            for (int i = 0; i < k; i++)
+            {
+                word &= word - 1;
+            }
+            return __builtin_ctzll(word);
+#endif
+        }
+    };
+
+    int _length;
+    int _bitLength;
+    vector<Level> _levels;
+    // _zeros[i] = number of zeros at level i; ones are stably moved after them
+    vector<int> _zeros;
+
+public:
+    template <typename T>
+    WaveletMatrix(const vector<T>& array)
+    {
+        vector<uint64_t> data(array.begin(), array.end());
+        Construct(data);
+    }
+
+    int Length()
+    {
+        return _length;
+    }
+
+    uint64_t Access(int pos)
+    {
+        uint64_t c = 0;
+        for (int i = 0; i < _bitLength; i++)
+        {
+            int bit = _levels[i].Get(pos);
+            c = (c << 1) | (uint64_t)bit;
+            pos = bit == 1 ? _zeros[i] + _levels[i].Rank1(pos) : _levels[i].Rank0(pos);
+        }
+
+        return c;
+    }
+
+    // occurrences of c in [0, pos)
+    int Rank(uint64_t c, int pos)
+    {
+        return Rank(c, 0, pos);
+    }
+
+    // occurrences of c in [l, r)
+    int Rank(uint64_t c, int l, int r)
+    {
+        if (_bitLength < 64 && (c >> _bitLength) != 0) return 0;
+        Descend(c, l, r);
+        return r - l;
+    }
+
+    // position of the k-th (0-indexed) occurrence of c, or -1
+    int Select(uint64_t c, int k)
+    {
+        if (_bitLength < 64 && (c >> _bitLength) != 0) return -1;
+
+        int l = 0, r = _length;
+        Descend(c, l, r);
+        if (k < 0 || k >= r - l) return -1;
+
+        int pos = l + k;
+        for (int i = _bitLength - 1; i >= 0; i--)
+        {
+            int bit = (int)((c >> (_bitLength - i - 1)) & 1);
+            pos = bit == 1 ? _levels[i].Select(1, pos - _zeros[i]) : _levels[i].Select(0, pos);
+        }
+        return pos;
+    }
+
+    // the k-th (0-indexed) smallest value in [l, r)
+    uint64_t KthSmallest(int l, int r, int k)
+    {
+        uint64_t val = 0;
+        for (int i = 0; i < _bitLength; i++)
+        {
+            int zeroBegin = _levels[i].Rank0(l);
+            int zeroEnd = _levels[i].Rank0(r);
+            int zero = zeroEnd - zeroBegin;
+            if (k < zero)
+            {
+                l = zeroBegin;
+                r = zeroEnd;
+                val <<= 1;
+            }
+            else
+            {
+                k -= zero;
+                l = _zeros[i] + l - zeroBegin;
+                r = _zeros[i] + r - zeroEnd;
+                val = (val << 1) | 1;
+            }
+        }
+
+        return val;
+    }
+
+    // position of the k-th (0-indexed) smallest value in [l, r), ties broken by position, or -1 as in wavelet_matrix.cs
+    int QuantileRange(int l, int r, int k)
+    {
+        if (r > _length || l >= _length || l >= r || k < 0 || k >= r - l)
+        {
+            return -1;
+        }
+
+        uint64_t val = KthSmallest(l, r, k);
+        // the answer is the (occurrences of val before l + index among the equal values in [l, r))-th val
+        int less = RankLessThan(val, l, r);
+        return Select(val, Rank(val, 0, l) + k - less);
+    }
+
+    int RangeMax(int l, int r)
+    {
+        return QuantileRange(l, r, r - l - 1);
+    }
+
+    int RangeMin(int l, int r)
+    {
+        return QuantileRange(l, r, 0);
+    }
+
+    // values < c in [l, r)
+    int RankLessThan(uint64_t c, int l, int r)
+    {
+        if (_bitLength < 64 && (c >> _bitLength) != 0) return r - l;
+
+        int less = 0;
+        for (int i = 0; i < _bitLength && l < r; i++)
+        {
+            int bit = (int)((c >> (_bitLength - i - 1)) & 1);
+            int zeroBegin = _levels[i].Rank0(l);
+            int zeroEnd = _levels[i].Rank0(r);
+            if (bit == 1)
+            {
+                less += zeroEnd - zeroBegin;
+                l = _zeros[i] + l - zeroBegin;
+                r = _zeros[i] + r - zeroEnd;
+            }
+            else
+            {
+                l = zeroBegin;
+                r = zeroEnd;
+            }
+        }
+
+        return less;
+    }
+
+    // values > c in [l, r)
+    int RankMoreThan(uint64_t c, int l, int r)
+    {
+        return (r - l) - RankLessThan(c, l, r) - Rank(c, l, r);
+    }
+
+    // values in [min, max) in [l, r)
+    int RankFrequency(int l, int r, uint64_t min, uint64_t max)
+    {
+        if (l >= r || min >= max) return 0;
+        return RankLessThan(max, l, r) - RankLessThan(min, l, r);
+    }
+
+    // the k most frequent values in [l, r) as (value, count), by decreasing count and then increasing value
+    vector<pair<uint64_t, int>> TopK(int l, int r, int k)
+    {
+        // a node is the subtree of values with a common prefix. Wider nodes come first, and among equal widths the
+        // one with the smallest possible value, so a leaf is only popped once no pending node can beat it.
+        struct Node
+        {
+            int Count;
+            int Depth;
+            int Left;
+            uint64_t Value;
+            uint64_t Smallest;
+
+            bool operator<(const Node& other) const
+            {
+                if (Count != other.Count) return Count < other.Count;
+                return Smallest > other.Smallest;
+            }
+        };
+
+        auto make = [&](int count, int depth, int left, uint64_t value)
+        {
+            int shift = _bitLength - depth;
+            return Node{count, depth, left, value, shift >= 64 ? 0 : value << shift};
+        };
+
+        vector<pair<uint64_t, int>> result;
+        priority_queue<Node> queue;
+        if (l < r)
+        {
+            queue.push(make(r - l, 0, l, 0));
+        }
+
+        while (!queue.empty() && (int)result.size() < k)
+        {
+            Node node = queue.top();
+            queue.pop();
+
+            if (node.Depth == _bitLength)
+            {
+                result.emplace_back(node.Value, node.Count);
+                continue;
+            }
+
+            const Level& level = _levels[node.Depth];
+            int left = node.Left, right = node.Left + node.Count;
+            int zeroBegin = level.Rank0(left);
+            int zeroEnd = level.Rank0(right);
+            if (zeroEnd > zeroBegin)
+            {
+                queue.push(make(zeroEnd - zeroBegin, node.Depth + 1, zeroBegin, node.Value << 1));
+            }
+            int ones = (right - left) - (zeroEnd - zeroBegin);
+            if (ones > 0)
+            {
+                queue.push(make(ones, node.Depth + 1, _zeros[node.Depth] + left - zeroBegin, (node.Value << 1) | 1));
+            }
+        }
+
+        return result;
+    }
+
+private:
+    void Construct(vector<uint64_t>& data)
+    {
+        _length = (int)data.size();
+
+        uint64_t maxValue = 0;
+        for (uint64_t v : data)
+        {
+            maxValue = max(maxValue, v);
+        }
+        _bitLength = maxValue == 0 ? 1 : 64 - __builtin_clzll(maxValue);
+
+        _levels.reserve(_bitLength);
+        _zeros.resize(_bitLength);
+
+        vector<uint64_t> next(_length);
+        vector<uint64_t> words((_length + 63) / 64);
+        for (int i = 0; i < _bitLength; i++)
+        {
+            int shift = _bitLength - i - 1;
+
+            fill(words.begin(), words.end(), 0);
+            for (int j = 0; j < _length; j++)
+            {
+                words[j / 64] |= ((data[j] >> shift) & 1) << (j % 64);
+            }
+            _levels.emplace_back(words, _length);
+
+            // stable partition without branches: zeros first, then ones
+            int zeros = _length - _levels.back().Ones();
+            int zeroPos = 0, onePos = zeros;
+            for (int j = 0; j < _length; j++)
+            {
+                uint64_t v = data[j];
+                int bit = (int)((v >> shift) & 1);
+                next[bit == 1 ? onePos : zeroPos] = v;
+                zeroPos += 1 - bit;
+                onePos += bit;
+            }
+
+            _zeros[i] = zeros;
+            data.swap(next);
+        }
+    }
+
+    // narrows [l, r) to the occurrences of c at the bottom level
+    inline void Descend(uint64_t c, int& l, int& r)
+    {
+        for (int i = 0; i < _bitLength && l < r; i++)
+        {
+            int bit = (int)((c >> (_bitLength - i - 1)) & 1);
+            if (bit == 1)
+            {
+                l = _zeros[i] + _levels[i].Rank1(l);
+                r = _zeros[i] + _levels[i].Rank1(r);
+            }
+            else
+            {
+                l = _levels[i].Rank0(l);
+                r = _levels[i].Rank0(r);
+            }
+        }
+    }
+};